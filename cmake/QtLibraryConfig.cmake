@@ -8,4 +8,5 @@ endif()
 set(CMAKE_INCLUDE_CURRENT_DIR ON)
 set(CMAKE_AUTOMOC ON)
 
-find_package(Qt5 COMPONENTS Widgets PrintSupport Network Test Svg REQUIRED)
+# Qt::SkipEmptyParts and QList(begin, end) need 5.14
+find_package(Qt5 5.14 COMPONENTS Widgets PrintSupport Network Test Svg REQUIRED)
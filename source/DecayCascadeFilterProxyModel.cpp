@@ -1,37 +1,285 @@
 #include "DecayCascadeFilterProxyModel.h"
+#include "DecayCascadeItemModel.h"
+#include "ENSDFTreeCache.h"
+#include "ENSDFTreeItem.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+#include <util/logger.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+static quint64 trigram(const QString &s, int i)
+{
+    return (quint64(s.at(i).unicode()) << 32)
+            | (quint64(s.at(i + 1).unicode()) << 16)
+            | quint64(s.at(i + 2).unicode());
+}
+
+static QVector<int> intersect(const QVector<int> &a, const QVector<int> &b)
+{
+    QVector<int> ret;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(ret));
+    return ret;
+}
 
 DecayCascadeFilterProxyModel::DecayCascadeFilterProxyModel(QObject *parent) :
     QSortFilterProxyModel(parent)
 {
+    debounce.setSingleShot(true);
+    debounce.setInterval(150);
+    connect(&debounce, SIGNAL(timeout()), this, SLOT(applyFilter()));
 }
 
-bool DecayCascadeFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+void DecayCascadeFilterProxyModel::setSourceModel(QAbstractItemModel *model)
 {
-    if (QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent))
-        return true;
+    if (sourceModel())
+    {
+        disconnect(sourceModel(), SIGNAL(modelAboutToBeReset()), this, SLOT(sourceAboutToChange()));
+        disconnect(sourceModel(), SIGNAL(layoutAboutToBeChanged()), this, SLOT(sourceAboutToChange()));
+        disconnect(sourceModel(), SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(sourceAboutToChange()));
+        disconnect(sourceModel(), SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(sourceAboutToChange()));
+        disconnect(sourceModel(), SIGNAL(modelReset()), this, SLOT(sourceChanged()));
+        disconnect(sourceModel(), SIGNAL(layoutChanged()), this, SLOT(sourceChanged()));
+        disconnect(sourceModel(), SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(sourceChanged()));
+        disconnect(sourceModel(), SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(sourceChanged()));
+    }
 
-    // accept if parent matches
-    QModelIndex parent = source_parent;
-    while (parent.isValid()) {
-        if (filterAcceptsThisRow(parent.row(), parent.parent()))
-            return true;
-        parent = parent.parent();
+    sourceAboutToChange();
+    QSortFilterProxyModel::setSourceModel(model);
+
+    if (model)
+    {
+        connect(model, SIGNAL(modelAboutToBeReset()), this, SLOT(sourceAboutToChange()));
+        connect(model, SIGNAL(layoutAboutToBeChanged()), this, SLOT(sourceAboutToChange()));
+        connect(model, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)), this, SLOT(sourceAboutToChange()));
+        connect(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(sourceAboutToChange()));
+        connect(model, SIGNAL(modelReset()), this, SLOT(sourceChanged()));
+        connect(model, SIGNAL(layoutChanged()), this, SLOT(sourceChanged()));
+        connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(sourceChanged()));
+        connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(sourceChanged()));
     }
+    sourceChanged();
+}
 
-    // accept if child matches (only direct children. not recursive!!)
-    QModelIndex item = sourceModel()->index(source_row, 0, source_parent);
-    if (!item.isValid())
+void DecayCascadeFilterProxyModel::sourceAboutToChange()
+{
+    // the index refers to source items, which may be gone after the change
+    indexed = false;
+    nodes.clear();
+    names.clear();
+    nodeOf.clear();
+    nodeOfCached.clear();
+    trigrams.clear();
+    matches.clear();
+    accepted.clear();
+}
+
+void DecayCascadeFilterProxyModel::sourceChanged()
+{
+    if (!pendingText.isEmpty())
+        applyFilter();
+}
+
+void DecayCascadeFilterProxyModel::setFilterText(const QString &text)
+{
+    pendingText = text;
+    debounce.start();
+}
+
+void DecayCascadeFilterProxyModel::applyFilter()
+{
+    debounce.stop();
+    QString text = pendingText.toLower();
+    if ((text == activeText) && (text.isEmpty() || indexed))
+        return;
+
+    if (text.isEmpty())
+    {
+        activeText.clear();
+        matches.clear();
+        accepted.clear();
+        invalidateFilter();
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // appending to the query can only drop matches
+    bool narrowing = indexed && !activeText.isEmpty() && text.startsWith(activeText);
+    if (!indexed)
+        buildIndex();
+
+    QStringList fragments = text.split(QRegularExpression("[*?]"), Qt::SkipEmptyParts);
+    QVector<int> cand = candidates(fragments);
+    if (narrowing)
+        cand = intersect(cand, matches);
+
+    QString pattern;
+    for (const QChar &c : text)
+    {
+        if (c == '*')
+            pattern += ".*";
+        else if (c == '?')
+            pattern += ".";
+        else
+            pattern += QRegularExpression::escape(QString(c));
+    }
+    QRegularExpression re(pattern);
+    re.optimize();
+
+    matches.clear();
+    for (int n : cand)
+        if (re.match(names.at(n)).hasMatch())
+            matches.append(n);
+
+    // matches bring along their ancestors and their whole subtree; every
+    // accepted node already has its ancestors accepted, so walks stop early
+    accepted.fill(0, nodes.size());
+    int covered = 0;
+    for (int m : matches)
+    {
+        for (int p = nodes.at(m).parent; (p >= 0) && !accepted.at(p); p = nodes.at(p).parent)
+            accepted[p] = 1;
+        for (int i = std::max(m, covered); i < nodes.at(m).end; ++i)
+            accepted[i] = 1;
+        covered = std::max(covered, nodes.at(m).end);
+    }
+
+    activeText = text;
+    invalidateFilter();
+
+    DBG("<DecayCascadeFilterProxyModel> '{}' matches {} of {} names ({} candidates) in {} ms",
+        text.toStdString(), matches.size(), nodes.size(), cand.size(), timer.elapsed());
+}
+
+QVector<int> DecayCascadeFilterProxyModel::candidates(const QStringList &fragments) const
+{
+    QVector<int> ret;
+    bool any = false;
+    for (const QString &f : fragments)
+        for (int i = 0; i + 3 <= f.size(); ++i)
+        {
+            auto it = trigrams.constFind(trigram(f, i));
+            if (it == trigrams.constEnd())
+                return QVector<int>();
+            ret = any ? intersect(ret, *it) : *it;
+            any = true;
+            if (ret.isEmpty())
+                return ret;
+        }
+
+    // too short to narrow down, every name has to be checked
+    if (!any)
+    {
+        ret.resize(nodes.size());
+        std::iota(ret.begin(), ret.end(), 0);
+    }
+    return ret;
+}
+
+void DecayCascadeFilterProxyModel::buildIndex()
+{
+    QElapsedTimer timer;
+    timer.start();
+    sourceAboutToChange();
+    if (sourceModel() && !indexFromCache(QModelIndex()))
+        indexSubtree(QModelIndex(), -1);
+    indexed = true;
+    DBG("<DecayCascadeFilterProxyModel> Indexed {} names, {} trigrams in {} ms",
+        nodes.size(), trigrams.size(), timer.elapsed());
+}
+
+int DecayCascadeFilterProxyModel::addNode(const QString &name, int parentNode)
+{
+    int node = nodes.size();
+    nodes.append({parentNode, 0});
+    names.append(name);
+
+    // nodes are numbered in order, so posting lists stay sorted
+    for (int i = 0; i + 3 <= name.size(); ++i)
+    {
+        QVector<int> &list = trigrams[trigram(name, i)];
+        if (list.isEmpty() || (list.last() != node))
+            list.append(node);
+    }
+    return node;
+}
+
+bool DecayCascadeFilterProxyModel::indexFromCache(const QModelIndex &item)
+{
+    // the cache only holds the display names
+    auto model = qobject_cast<DecayCascadeItemModel*>(sourceModel());
+    if (!model || (filterKeyColumn() != 0) || (filterRole() != Qt::DisplayRole))
         return false;
-    //check if there are children
-    int childCount = item.model()->rowCount(item);
-    for (int i = 0; i < childCount; i++)
-        if (filterAcceptsThisRow(i, item))
-            return true;
 
-    return false;
+    ENSDFTreeItem *it = model->item(item);
+    if (!it || !it->cache() || it->childrenLoaded())
+        return false;
+
+    int node = item.isValid() ? nodeOf.value(item.internalId(), -1) : -1;
+    indexCachedSubtree(it->cache(), it->cacheNode(), node);
+    return true;
 }
 
-bool DecayCascadeFilterProxyModel::filterAcceptsThisRow(int source_row, const QModelIndex &source_parent) const
+void DecayCascadeFilterProxyModel::indexSubtree(const QModelIndex &parent, int parentNode)
 {
-    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+    int rows = sourceModel()->rowCount(parent);
+    for (int r = 0; r < rows; ++r)
+    {
+        QModelIndex item = sourceModel()->index(r, 0, parent);
+        if (!item.isValid())
+            continue;
+        QString name = sourceModel()->index(r, filterKeyColumn(), parent)
+                .data(filterRole()).toString().toLower();
+
+        int node = addNode(name, parentNode);
+        nodeOf.insert(item.internalId(), node);
+
+        if (!indexFromCache(item))
+            indexSubtree(item, node);
+        nodes[node].end = nodes.size();
+    }
+}
+
+void DecayCascadeFilterProxyModel::indexCachedSubtree(const ENSDFTreeCache *cache,
+                                                      quint32 parent, int parentNode)
+{
+    if (!cache->childrenInRange(parent))
+        return;
+    const ENSDFTreeCache::Node &p = cache->node(parent);
+    for (quint32 c = p.first_child; c < p.first_child + p.child_count; ++c)
+    {
+        int node = addNode(cache->name(c).toLower(), parentNode);
+        nodeOfCached.insert(c, node);
+        indexCachedSubtree(cache, c, node);
+        nodes[node].end = nodes.size();
+    }
+}
+
+bool DecayCascadeFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+{
+    if (activeText.isEmpty() || !indexed)
+        return true;
+
+    QModelIndex item = sourceModel()->index(source_row, 0, source_parent);
+    auto it = nodeOf.constFind(item.internalId());
+    if (it != nodeOf.constEnd())
+        return accepted.at(*it);
+
+    // instantiated after indexing, from a subtree read out of the cache
+    auto model = qobject_cast<DecayCascadeItemModel*>(sourceModel());
+    ENSDFTreeItem *treeItem = model ? model->item(item) : nullptr;
+    if (item.isValid() && treeItem && treeItem->cache())
+    {
+        auto cached = nodeOfCached.constFind(treeItem->cacheNode());
+        if (cached != nodeOfCached.constEnd())
+            return accepted.at(*cached);
+    }
+    return true;
 }
@@ -1,19 +1,71 @@
 #pragma once
 
 #include <QSortFilterProxyModel>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
 
+class ENSDFTreeCache;
+
+/**
+ * @brief Filters the decay tree by name, keeping matches with their
+ *  ancestors and descendants.
+ *
+ * Names are indexed by trigram once per source model, so a query only
+ * verifies the rows sharing its trigrams. Subtrees still in the decay tree
+ * cache are indexed from its tables, so filtering does not instantiate
+ * their items. Typing is debounced, and a query
+ * that extends the previous one only narrows the previous matches.
+ * '*' and '?' act as wildcards, matching is case insensitive.
+ */
 class DecayCascadeFilterProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 public:
     explicit DecayCascadeFilterProxyModel(QObject *parent = 0);
-    
+
+    virtual void setSourceModel(QAbstractItemModel *sourceModel);
+
 signals:
-    
+
 public slots:
+    /// applies the filter once typing pauses
+    void setFilterText(const QString &text);
+    /// applies a pending filter right away
+    void applyFilter();
 
 protected:
     virtual bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const;
-    virtual bool filterAcceptsThisRow(int source_row, const QModelIndex &source_parent) const;
 
+private slots:
+    void sourceAboutToChange();
+    void sourceChanged();
+
+private:
+    struct Node
+    {
+        int parent;
+        int end;  // one past the last node of the subtree, in depth-first order
+    };
+
+    QTimer debounce;
+    QString pendingText;
+    QString activeText;
+
+    bool indexed {false};
+    QVector<Node> nodes;
+    QVector<QString> names;
+    QHash<quintptr, int> nodeOf;
+    QHash<quint32, int> nodeOfCached;  // by decay tree cache node
+    QHash<quint64, QVector<int>> trigrams;
+
+    QVector<int> matches;  // nodes matching activeText, ascending
+    QVector<char> accepted;
+
+    void buildIndex();
+    void indexSubtree(const QModelIndex &parent, int parentNode);
+    void indexCachedSubtree(const ENSDFTreeCache *cache, quint32 parent, int parentNode);
+    int addNode(const QString &name, int parentNode);
+    bool indexFromCache(const QModelIndex &item);
+    QVector<int> candidates(const QStringList &fragments) const;
 };
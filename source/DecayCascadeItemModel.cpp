@@ -12,6 +12,7 @@ DecayCascadeItemModel::DecayCascadeItemModel(QPointer<ENSDFDataSource> datasourc
 
 DecayCascadeItemModel::~DecayCascadeItemModel()
 {
+  delete results;
 }
 
 void DecayCascadeItemModel::setDataSource(ENSDFDataSource *datasource)
@@ -21,15 +22,40 @@ void DecayCascadeItemModel::setDataSource(ENSDFDataSource *datasource)
   endResetModel();
 }
 
+void DecayCascadeItemModel::setResults(ENSDFTreeItem *resultsRoot)
+{
+  beginResetModel();
+  delete results;
+  results = resultsRoot;
+  endResetModel();
+}
+
+ENSDFTreeItem *DecayCascadeItemModel::rootItem() const
+{
+  if (results)
+    return results;
+  if (ds)
+    return ds->rootItem();
+  return nullptr;
+}
+
+QVariant DecayCascadeItemModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  ENSDFTreeItem *root = rootItem();
+  if (root && (orientation == Qt::Horizontal) && (role == Qt::DisplayRole))
+    return root->data(section);
+  return QVariant();
+}
+
 int DecayCascadeItemModel::columnCount(const QModelIndex &parent) const
 {
-  if (!ds)
+  if (!rootItem())
     return 0;
 
   if (parent.isValid())
     return static_cast<ENSDFTreeItem*>(parent.internalPointer())->columnCount();
   else
-    return ds->rootItem()->columnCount();
+    return rootItem()->columnCount();
 }
 
 QVariant DecayCascadeItemModel::data(const QModelIndex &index, int role) const
@@ -57,13 +83,13 @@ QModelIndex DecayCascadeItemModel::index(int row, int column, const QModelIndex
   if (!hasIndex(row, column, parent))
     return QModelIndex();
 
-  if (!ds)
+  if (!rootItem())
     return QModelIndex();
 
   ENSDFTreeItem *parentItem;
 
   if (!parent.isValid())
-    parentItem = ds->rootItem();
+    parentItem = rootItem();
   else
     parentItem = static_cast<ENSDFTreeItem*>(parent.internalPointer());
 
@@ -77,7 +103,7 @@ QModelIndex DecayCascadeItemModel::index(int row, int column, const QModelIndex
 
 int DecayCascadeItemModel::rowCount(const QModelIndex &parent) const
 {
-  if (!ds)
+  if (!rootItem())
     return 0;
 
   ENSDFTreeItem *parentItem;
@@ -85,7 +111,7 @@ int DecayCascadeItemModel::rowCount(const QModelIndex &parent) const
     return 0;
 
   if (!parent.isValid())
-    parentItem = ds->rootItem();
+    parentItem = rootItem();
   else
     parentItem = static_cast<ENSDFTreeItem*>(parent.internalPointer());
 
@@ -107,10 +133,17 @@ Qt::ItemFlags DecayCascadeItemModel::flags(const QModelIndex &index) const
   return result;
 }
 
+ENSDFTreeItem *DecayCascadeItemModel::item(const QModelIndex &index) const
+{
+  if (!index.isValid())
+    return rootItem();
+  return static_cast<ENSDFTreeItem*>(index.internalPointer());
+}
+
 DecayScheme DecayCascadeItemModel::decay(const QModelIndex &index,
                                          bool merge) const
 {
-  if (!index.isValid())
+  if (!index.isValid() || !ds)
     return DecayScheme();
 
   ENSDFTreeItem *item = static_cast<ENSDFTreeItem*>(index.internalPointer());
@@ -137,7 +170,7 @@ QModelIndex DecayCascadeItemModel::parent(const QModelIndex &index) const
   ENSDFTreeItem *childItem = static_cast<ENSDFTreeItem*>(index.internalPointer());
   ENSDFTreeItem *parentItem = childItem->parent();
 
-  if (parentItem == ds->rootItem())
+  if (parentItem == rootItem())
     return QModelIndex();
 
   return createIndex(parentItem->row(), 0, parentItem);
@@ -17,7 +17,12 @@ public:
 
     virtual void setDataSource(ENSDFDataSource *datasource);
 
+    /// shows the given tree instead of the full selection tree, takes ownership
+    void setResults(ENSDFTreeItem *resultsRoot);
+
     virtual int columnCount(const QModelIndex & parent = QModelIndex()) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation,
+                                int role = Qt::DisplayRole) const;
     virtual QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const;
     virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
     virtual QModelIndex parent(const QModelIndex & index ) const;
@@ -25,6 +30,9 @@ public:
     virtual Qt::ItemFlags flags(const QModelIndex &index) const;
 
     virtual DecayScheme decay(const QModelIndex &index, bool merge) const;
+
+    /// the item behind an index, the root for an invalid index
+    ENSDFTreeItem *item(const QModelIndex &index) const;
 //    virtual Decay::CascadeIdentifier cascade(const QModelIndex &index) const;
     
 signals:
@@ -33,5 +41,8 @@ public slots:
 
 private:
     QPointer<ENSDFDataSource> ds;
+    ENSDFTreeItem *results {nullptr};
+
+    ENSDFTreeItem *rootItem() const;
     
 };
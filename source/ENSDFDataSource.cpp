@@ -8,11 +8,14 @@
 #include <QMutexLocker>
 #include <QFileDialog>
 #include <QDesktopServices>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QSet>
 
 #include <util/logger.h>
+#include <util/trace.h>
 
-const quint32 ENSDFDataSource::magicNumber = 0x4b616945;
-const quint32 ENSDFDataSource::cacheVersion = 5;
+#include <sstream>
 
 ENSDFDataSource::ENSDFDataSource(QObject *parent)
   : QObject(parent)
@@ -37,9 +40,9 @@ ENSDFDataSource::ENSDFDataSource(QObject *parent)
   }
   parser = ENSDFParser(s.value("ensdfPath", ".").toString().toStdString());
 
-  // load decay cache
-  if (!loadENSDFCache())
-    createENSDFCache();
+  // load decay cache and re-index whatever changed since it was written
+  updateENSDFCache();
+  updateNuclideTable();
 }
 
 ENSDFDataSource::~ENSDFDataSource()
@@ -52,13 +55,118 @@ ENSDFTreeItem *ENSDFDataSource::rootItem() const
   return root;
 }
 
+const GammaIndex &ENSDFDataSource::gammaIndex() const
+{
+  return gammas;
+}
+
+const NuclideTable &ENSDFDataSource::nuclideTable() const
+{
+  return nuclides;
+}
+
+const ActivationSearch &ENSDFDataSource::activationSearch() const
+{
+  return *activation;
+}
+
+void ENSDFDataSource::updateNuclideTable()
+{
+  nuclides.clear();
+  nuclides.add_halflives(gammas);
+
+  QFile f(":/neutron_capture.csv");
+  if (f.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    std::istringstream is(f.readAll().toStdString());
+    DBG("<ENSDFDataSource> Read capture data for {} nuclides",
+        nuclides.load_capture_data(is));
+  }
+  else
+    WARN("<ENSDFDataSource> Could not open bundled capture data");
+
+  // joins the index with the table, so it goes stale with either of them
+  activation.reset(new ActivationSearch(gammas, nuclides));
+}
+
+ENSDFTreeItem *ENSDFDataSource::resultsTree(const QList<QPair<quint32, QString>> &results,
+                                            const QString &detailHeader,
+                                            bool grouped) const
+{
+  // same shape as the selection tree (A -> daughter -> decay), or a flat
+  // list of decays in the given order
+  ENSDFTreeItem *ret = new ENSDFTreeItem(ENSDFTreeItem::RootType,
+                                         NuclideId(),
+                                         QList<QVariant>() << "Decay" << detailHeader,
+                                         false);
+
+  if (!grouped)
+  {
+    for (const auto &r : results)
+    {
+      const auto &d = gammas.dataset(r.first);
+      new ENSDFTreeItem(ENSDFTreeItem::DecayType, d.daughter,
+                        QList<QVariant>() << QString::fromStdString(d.name) << r.second,
+                        true, ret);
+    }
+    return ret;
+  }
+
+  QMap<uint16_t, QList<QPair<quint32, QString>>> chains;
+  for (const auto &r : results)
+    chains[gammas.dataset(r.first).A].append(r);
+
+  for (auto it = chains.begin(); it != chains.end(); ++it)
+  {
+    NuclideId na;
+    na.set_A(it.key());
+    ENSDFTreeItem *aa = new ENSDFTreeItem(ENSDFTreeItem::DaughterType, na,
+                                          QList<QVariant>() << ("A=" + QString::number(it.key())) << "",
+                                          false, ret);
+
+    QMap<NuclideId, ENSDFTreeItem*> daughters;
+    for (const auto &r : it.value())
+    {
+      const auto &d = gammas.dataset(r.first);
+      ENSDFTreeItem *di = daughters.value(d.daughter, nullptr);
+      if (!di)
+      {
+        di = new ENSDFTreeItem(ENSDFTreeItem::DaughterType, d.daughter,
+                               QList<QVariant>() << QString::fromStdString(d.daughter.symbolicName()) << "",
+                               false, aa);
+        daughters[d.daughter] = di;
+      }
+      new ENSDFTreeItem(ENSDFTreeItem::DecayType, d.daughter,
+                        QList<QVariant>() << QString::fromStdString(d.name) << r.second,
+                        true, di);
+    }
+  }
+
+  return ret;
+}
+
+QString ENSDFDataSource::gammaIndexPath() const
+{
+  return QDir(cachePath).absoluteFilePath("nuclei_gamma.index");
+}
+
 DecayScheme ENSDFDataSource::decay(const ENSDFTreeItem *item, bool merge)
 {
+  TRACE_SCOPE("ENSDFDataSource::decay");
   QMutexLocker locker(&m);
   const ENSDFTreeItem *eitem = dynamic_cast<const ENSDFTreeItem*>(item);
   if (!eitem)
     return DecayScheme();
 
+  if (eitem->isSelectable() && (eitem->type() == ENSDFTreeItem::DecayType))
+  {
+    // decay items carry their daughter, wherever they sit in a tree
+    dparser = parser.get_dp(eitem->id().A());
+    return DecayScheme(dparser.decay(eitem->id(),
+                                     eitem->data(0).toString().toStdString(),
+                                     merge));
+  }
+
   if (eitem->isSelectable())
   {
     if (eitem->parent()
@@ -97,7 +205,7 @@ void ENSDFDataSource::deleteDatabaseAndCache()
     return;
   foreach (uint16_t a, aList)
   {
-    QFile f(s.value("ensdfPath", ".").toString() + QString("/ensdf.%1").arg(a, int(3), int(10), QChar('0')));
+    QFile f(dataFilePath(a));
     if (f.exists())
       f.remove();
   }
@@ -111,6 +219,7 @@ void ENSDFDataSource::deleteCache()
   // delete file
   if (f.exists())
     f.remove();
+  QFile::remove(gammaIndexPath());
   QCoreApplication::exit(6000); // tells the code in main.cpp to restart the application!
 }
 
@@ -146,46 +255,46 @@ QList<uint16_t> ENSDFDataSource::getAvailableDataFileNumbers()
     firsttry = false;
   }
 
-  return parser.masses();
+  const auto& masses = parser.masses();
+  return QList<uint16_t>(masses.begin(), masses.end());
 }
 
 
-bool ENSDFDataSource::loadENSDFCache()
+QString ENSDFDataSource::dataFilePath(uint16_t a) const
 {
-  QSettings s;
-
-  // return if cache file is missing
-  QFile f(QDir(cachePath).absoluteFilePath("nuclei_ensdf.cache"));
-  if (!f.open(QIODevice::ReadOnly))
-    return false;
+  return QString::fromStdString(parser.directory())
+      + QString("/ensdf.%1").arg(a, int(3), int(10), QChar('0'));
+}
 
-  // make sure ensdf files are available
-  if (getAvailableDataFileNumbers().isEmpty())
-    return false;
+ENSDFDataSource::FileSignature ENSDFDataSource::fileSignature(uint16_t a, bool with_hash) const
+{
+  FileSignature ret;
+  QFileInfo fi(dataFilePath(a));
+  ret.size = fi.size();
+  ret.modified = fi.lastModified().toMSecsSinceEpoch();
+  if (!with_hash)
+    return ret;
+
+  QFile f(fi.absoluteFilePath());
+  QCryptographicHash h(QCryptographicHash::Sha1);
+  if (f.open(QIODevice::ReadOnly) && h.addData(&f))
+    ret.hash = h.result();
+  return ret;
+}
 
-  QDataStream in(&f);
-  quint32 magic;
-  in >> magic;
-  if (magic != magicNumber)
-    return false;
-  quint32 version;
-  in >> version;
-  if (version != cacheVersion)
-    return false;
-  qint32 qtversion;
-  in >> qtversion;
-  in.setVersion(qtversion);
-  QString ensdfversion;
-  in >> ensdfversion;
-  if (ensdfversion != s.value("ensdfVersion").toString())
+bool ENSDFDataSource::loadENSDFCache()
+{
+  if (!cache.open(QDir(cachePath).absoluteFilePath("nuclei_ensdf.cache")))
     return false;
 
-  in >> (*root);
-
+  // nodes are instantiated from the mapping only as the tree is expanded
+  delete root;
+  root = new ENSDFTreeItem(&cache, 0);
+  signatures = cache.signatures();
   return true;
 }
 
-void ENSDFDataSource::createENSDFCache()
+void ENSDFDataSource::updateENSDFCache()
 {
   QWidget *pwid = qobject_cast<QWidget*>(parent());
 
@@ -194,71 +303,168 @@ void ENSDFDataSource::createENSDFCache()
   if (aList.isEmpty())
     return;
 
-  // open cache file
-  //  first try to read cache (path might be different than before)
-  if (loadENSDFCache())
+  bool changed = !loadENSDFCache();
+
+  // the gamma index is kept in step with the tree, without it every chain
+  // has to be parsed again
+  if (!gammas.load(gammaIndexPath().toStdString()))
+  {
+    gammas.clear();
+    signatures.clear();
+  }
+
+  // forget mass chains whose files have disappeared
+  QSet<uint16_t> available;
+  std::set<uint16_t> removed;
+  foreach (uint16_t a, aList)
+    available.insert(a);
+  foreach (uint16_t a, signatures.keys())
+    if (!available.contains(a))
+    {
+      signatures.remove(a);
+      removed.insert(a);
+      changed = true;
+    }
+
+  // size and mtime are cheap to check, content is only hashed if they differ
+  QList<uint16_t> stale;
+  foreach (uint16_t a, aList)
+  {
+    FileSignature current = fileSignature(a, false);
+    auto cached = signatures.find(a);
+    if ((cached != signatures.end())
+        && (cached->size == current.size)
+        && (cached->modified == current.modified))
+      continue;
+
+    current = fileSignature(a, true);
+    changed = true;
+    if ((cached != signatures.end())
+        && (cached->size == current.size)
+        && (cached->hash == current.hash))
+    {
+      cached->modified = current.modified;
+      continue;
+    }
+
+    signatures[a] = current;
+    stale.append(a);
+    removed.insert(a);
+  }
+
+  if (!changed)
     return;
 
+  // detach the unchanged mass chains from the mapping before it is rewritten
+  ENSDFTreeItem *fresh = new ENSDFTreeItem(ENSDFTreeItem::RootType);
+  for (int i=0; i < root->childCount(); ++i)
+  {
+    ENSDFTreeItem *aa = root->child(i);
+    if (signatures.contains(aa->id().A()) && !stale.contains(aa->id().A()))
+      copyItem(aa, fresh);
+  }
+  delete root;
+  root = fresh;
+  cache.close();
+  gammas.remove_chains(removed);
+
+  if (!stale.isEmpty())
+  {
+    DBG("<ENSDFDataSource> Re-indexing {} of {} mass chains",
+        stale.size(), aList.size());
+
+    QProgressDialog pd(pwid);
+    pd.setWindowTitle("Nuclei Cache");
+    pd.setLabelText("Updating Decay Cache...");
+    pd.setMaximum(stale.size());
+    pd.setWindowModality(Qt::WindowModal);
+    pd.setCancelButton(0);
+
+    for (int i=0; i < stale.size(); ++i)
+    {
+      insertMassChainItem(createMassChainItem(stale.at(i)));
+      pd.setValue(i);
+    }
+    pd.setValue(stale.size());
+  }
+
+  gammas.sort();
+  if (!gammas.save(gammaIndexPath().toStdString()))
+    WARN("<ENSDFDataSource> Could not write gamma index to {}",
+         gammaIndexPath().toStdString());
+
+  if (writeENSDFCache())
+    loadENSDFCache();
+}
+
+bool ENSDFDataSource::writeENSDFCache()
+{
+  QWidget *pwid = qobject_cast<QWidget*>(parent());
+
   //create directory if it does not exist
   QDir cacheDir(cachePath);
   if (!cacheDir.exists())
     cacheDir.mkpath(cachePath);
-  QFile f(cacheDir.absoluteFilePath("nuclei_ensdf.cache"));
-  while (!f.open(QIODevice::WriteOnly))
+  while (!ENSDFTreeCache::write(cacheDir.absoluteFilePath("nuclei_ensdf.cache"), *root, signatures))
     if (QMessageBox::Close == QMessageBox::warning(pwid, "ENSDF Folder is not writeable!", "<p>The currently selected folder <br />" + cachePath + "<br /> is not writeable!</p><p>It must be writeable to create a cache file.</p>", QMessageBox::Close, QMessageBox::Close)) {
       qApp->quit();
-      return;
+      return false;
     }
+  return true;
+}
 
-  QSettings s;
-  QDataStream out(&f);
-  out << magicNumber;
-  out << cacheVersion;
-  out << qint32(out.version());
-  out << s.value("ensdfVersion").toString();
-
-  // create cache structures
-  QProgressDialog pd(pwid);
-  pd.setWindowTitle("Nuclei Cache");
-  pd.setLabelText("Creating Decay Cache...");
-  pd.setMaximum(aList.size());
-  pd.setWindowModality(Qt::WindowModal);
-  pd.setCancelButton(0);
-
-  for (auto &a : aList)
-  {
-    NuclideId na;
-    na.set_A(a);
-    ENSDFTreeItem *aa = new ENSDFTreeItem(ENSDFTreeItem::DaughterType,
-                                          na,
-                                          QList<QVariant>() << ("A=" + QString::number(a)),
-                                          true,
-                                          root);
+ENSDFTreeItem *ENSDFDataSource::createMassChainItem(uint16_t a)
+{
+  NuclideId na;
+  na.set_A(a);
+  ENSDFTreeItem *aa = new ENSDFTreeItem(ENSDFTreeItem::DaughterType,
+                                        na,
+                                        QList<QVariant>() << ("A=" + QString::number(a)),
+                                        true);
 
-    auto mc = parser.get_dp(a);
+  auto mc = parser.get_dp(a);
+  gammas.add_chain(a, mc);
 
-    for (auto &daughter : mc.daughters())
-    {
+  for (auto &daughter : mc.daughters())
+  {
 
-      ENSDFTreeItem *d = new ENSDFTreeItem(ENSDFTreeItem::DaughterType,
-                                           daughter,
-                                           QList<QVariant>() << QString::fromStdString(daughter.symbolicName()),
-                                           true,
-                                           aa);
+    ENSDFTreeItem *d = new ENSDFTreeItem(ENSDFTreeItem::DaughterType,
+                                         daughter,
+                                         QList<QVariant>() << QString::fromStdString(daughter.symbolicName()),
+                                         true,
+                                         aa);
 
-      for (auto &decay : mc.decays(daughter))
-      {
-        QString st = QString::fromStdString(decay);
-        new ENSDFTreeItem(ENSDFTreeItem::DecayType,
-                          daughter,
-                          QList<QVariant>() << st,
-                          true, d);
-      }
+    for (auto &decay : mc.decays(daughter))
+    {
+      QString st = QString::fromStdString(decay);
+      new ENSDFTreeItem(ENSDFTreeItem::DecayType,
+                        daughter,
+                        QList<QVariant>() << st,
+                        true, d);
     }
-
-    pd.setValue(a);
   }
-  pd.setValue(aList.size());
 
-  out << (*root);
+  return aa;
+}
+
+void ENSDFDataSource::insertMassChainItem(ENSDFTreeItem *item)
+{
+  // mass chains are kept in ascending order of A
+  int row = 0;
+  while ((row < root->childCount())
+         && (root->child(row)->id().A() < item->id().A()))
+    ++row;
+  root->insertChild(row, item);
+}
+
+ENSDFTreeItem *ENSDFDataSource::copyItem(ENSDFTreeItem *item, ENSDFTreeItem *parent)
+{
+  ENSDFTreeItem *ret = new ENSDFTreeItem(item->type(),
+                                         item->id(),
+                                         QList<QVariant>() << item->data(0),
+                                         item->isSelectable(),
+                                         parent);
+  for (int i=0; i < item->childCount(); ++i)
+    copyItem(item->child(i), ret);
+  return ret;
 }
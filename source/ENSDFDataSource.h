@@ -9,7 +9,13 @@
 #include <QDir>
 
 #include "ENSDFTreeItem.h"
+#include "ENSDFTreeCache.h"
 #include <ensdf/Parser.h>
+#include <search/ActivationSearch.h>
+#include <search/GammaIndex.h>
+#include <search/NuclideTable.h>
+
+#include <memory>
 
 
 class ENSDFDataSource : public QObject
@@ -24,23 +30,49 @@ public:
 
     virtual DecayScheme decay(const ENSDFTreeItem *item, bool merge);
 
+    const GammaIndex &gammaIndex() const;
+    const NuclideTable &nuclideTable() const;
+    const ActivationSearch &activationSearch() const;
+
+    /**
+     * @brief Builds a standalone selection tree holding only the given
+     *  datasets of the gamma index, each with a line of detail text.
+     *  Unless grouped by A and daughter, decays keep the order given.
+     */
+    ENSDFTreeItem *resultsTree(const QList<QPair<quint32, QString>> &results,
+                               const QString &detailHeader,
+                               bool grouped = true) const;
+
 public slots:
     void deleteDatabaseAndCache();
     void deleteCache();
 
 private:
+    using FileSignature = ENSDFTreeCache::FileSignature;
+
     QList<uint16_t> getAvailableDataFileNumbers();
+    QString dataFilePath(uint16_t a) const;
+    QString gammaIndexPath() const;
+    FileSignature fileSignature(uint16_t a, bool with_hash) const;
 
     QString cachePath;
     QString defaultPath;
 
-    static const quint32 magicNumber;
-    static const quint32 cacheVersion;
-
     bool loadENSDFCache();
-    void createENSDFCache();
+    void updateENSDFCache();
+    bool writeENSDFCache();
+    void updateNuclideTable();
+
+    ENSDFTreeItem *createMassChainItem(uint16_t a);
+    static ENSDFTreeItem *copyItem(ENSDFTreeItem *item, ENSDFTreeItem *parent);
+    void insertMassChainItem(ENSDFTreeItem *item);
 
+    ENSDFTreeCache cache;
     ENSDFTreeItem *root;
+    QMap<uint16_t, FileSignature> signatures;
+    GammaIndex gammas;
+    NuclideTable nuclides;
+    std::unique_ptr<ActivationSearch> activation;
 
     ENSDFParser parser;
     DaughterParser dparser;
@@ -0,0 +1,205 @@
+#include "ENSDFTreeCache.h"
+#include "ENSDFTreeItem.h"
+
+#include <QSaveFile>
+#include <QQueue>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+#include <util/logger.h>
+
+const quint32 ENSDFTreeCache::magicNumber = 0x4b616945;
+const quint32 ENSDFTreeCache::cacheVersion = 7;
+
+ENSDFTreeCache::~ENSDFTreeCache()
+{
+  close();
+}
+
+bool ENSDFTreeCache::open(const QString &path)
+{
+  close();
+
+  file_.setFileName(path);
+  if (!file_.open(QIODevice::ReadOnly))
+    return false;
+
+  qint64 size = file_.size();
+  if (size < qint64(sizeof(Header)))
+  {
+    close();
+    return false;
+  }
+
+  data_ = file_.map(0, size);
+  if (!data_)
+  {
+    close();
+    return false;
+  }
+
+  header_ = reinterpret_cast<const Header*>(data_);
+  if ((header_->magic != magicNumber) ||
+      (header_->version != cacheVersion) ||
+      !header_->node_count)
+  {
+    close();
+    return false;
+  }
+
+  qint64 expected = qint64(sizeof(Header))
+      + qint64(header_->chain_count) * qint64(sizeof(ChainRecord))
+      + qint64(header_->node_count) * qint64(sizeof(Node))
+      + qint64(header_->string_size);
+  if (expected != size)
+  {
+    WARN("<ENSDFTreeCache> Cache file {} is truncated", path.toStdString());
+    close();
+    return false;
+  }
+
+  chains_ = reinterpret_cast<const ChainRecord*>(data_ + sizeof(Header));
+  nodes_ = reinterpret_cast<const Node*>(chains_ + header_->chain_count);
+  strings_ = reinterpret_cast<const char*>(nodes_ + header_->node_count);
+  return true;
+}
+
+void ENSDFTreeCache::close()
+{
+  if (data_)
+    file_.unmap(const_cast<uchar*>(data_));
+  file_.close();
+  data_ = nullptr;
+  header_ = nullptr;
+  chains_ = nullptr;
+  nodes_ = nullptr;
+  strings_ = nullptr;
+}
+
+bool ENSDFTreeCache::isOpen() const
+{
+  return data_;
+}
+
+quint32 ENSDFTreeCache::nodeCount() const
+{
+  if (!header_)
+    return 0;
+  return header_->node_count;
+}
+
+const ENSDFTreeCache::Node &ENSDFTreeCache::node(quint32 idx) const
+{
+  return nodes_[idx];
+}
+
+bool ENSDFTreeCache::childrenInRange(quint32 idx) const
+{
+  // children always follow their parent, which also rules out cycles
+  const Node &n = nodes_[idx];
+  return (n.first_child > idx)
+      && (quint64(n.first_child) + n.child_count <= header_->node_count);
+}
+
+QString ENSDFTreeCache::name(quint32 idx) const
+{
+  const Node &n = nodes_[idx];
+  if (quint64(n.name_offset) + n.name_size > header_->string_size)
+    return QString();
+  return QString::fromUtf8(strings_ + n.name_offset, int(n.name_size));
+}
+
+NuclideId ENSDFTreeCache::id(quint32 idx) const
+{
+  const Node &n = nodes_[idx];
+  return NuclideId::fromAZ(n.A, n.Z);
+}
+
+QMap<uint16_t, ENSDFTreeCache::FileSignature> ENSDFTreeCache::signatures() const
+{
+  QMap<uint16_t, FileSignature> ret;
+  if (!header_)
+    return ret;
+  for (quint32 i=0; i < header_->chain_count; ++i)
+  {
+    const ChainRecord &c = chains_[i];
+    FileSignature sig;
+    sig.size = c.size;
+    sig.modified = c.modified;
+    sig.hash = QByteArray(c.hash, std::min(int(c.hash_size), int(sizeof(c.hash))));
+    ret[c.A] = sig;
+  }
+  return ret;
+}
+
+bool ENSDFTreeCache::write(const QString &path,
+                           ENSDFTreeItem &root,
+                           const QMap<uint16_t, FileSignature> &signatures)
+{
+  // breadth-first, so that the children of every node end up contiguous
+  QVector<Node> nodes;
+  QByteArray strings;
+  QQueue<ENSDFTreeItem*> queue;
+
+  nodes.append(Node());
+  queue.enqueue(&root);
+  for (quint32 idx = 0; !queue.isEmpty(); ++idx)
+  {
+    ENSDFTreeItem *item = queue.dequeue();
+    QByteArray name = item->data(0).toString().toUtf8();
+
+    Node &n = nodes[int(idx)];
+    n.first_child = quint32(nodes.size());
+    n.child_count = quint32(item->childCount());
+    n.name_offset = quint32(strings.size());
+    n.name_size = quint32(name.size());
+    n.A = item->id().A();
+    n.Z = item->id().Z();
+    n.type = quint8(item->type());
+    n.selectable = item->isSelectable();
+    n.reserved = 0;
+    strings.append(name);
+
+    for (int i=0; i < item->childCount(); ++i)
+    {
+      Node c = Node();
+      c.parent = idx;
+      nodes.append(c);
+      queue.enqueue(item->child(i));
+    }
+  }
+  nodes[0].parent = 0;
+
+  QVector<ChainRecord> chains;
+  for (auto it = signatures.begin(); it != signatures.end(); ++it)
+  {
+    ChainRecord c;
+    std::memset(&c, 0, sizeof(c));
+    c.A = it.key();
+    c.size = it->size;
+    c.modified = it->modified;
+    c.hash_size = quint16(std::min(it->hash.size(), int(sizeof(c.hash))));
+    std::memcpy(c.hash, it->hash.constData(), c.hash_size);
+    chains.append(c);
+  }
+
+  Header h;
+  h.magic = magicNumber;
+  h.version = cacheVersion;
+  h.chain_count = quint32(chains.size());
+  h.node_count = quint32(nodes.size());
+  h.string_size = quint32(strings.size());
+  h.reserved = 0;
+
+  QSaveFile f(path);
+  if (!f.open(QIODevice::WriteOnly))
+    return false;
+  f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  f.write(reinterpret_cast<const char*>(chains.constData()),
+          qint64(chains.size()) * qint64(sizeof(ChainRecord)));
+  f.write(reinterpret_cast<const char*>(nodes.constData()),
+          qint64(nodes.size()) * qint64(sizeof(Node)));
+  f.write(strings);
+  return f.commit();
+}
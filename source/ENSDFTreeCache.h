@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QFile>
+#include <QMap>
+#include <QString>
+#include <QByteArray>
+
+#include <NucData/nid.h>
+
+class ENSDFTreeItem;
+
+/**
+ * @brief Read-only, memory-mapped image of the decay selection tree.
+ *
+ * The file consists of a header, one record per mass chain holding the
+ * signature of its ensdf.NNN file, the node array and a UTF-8 string table.
+ * Children of a node are stored contiguously, so the tree can be walked
+ * directly from the mapping without any pointer fix-ups.
+ */
+class ENSDFTreeCache
+{
+public:
+  /// identifies the state of one ensdf.NNN file at the time it was indexed
+  struct FileSignature
+  {
+    qint64 size {0};
+    qint64 modified {0};
+    QByteArray hash;
+  };
+
+  struct Node
+  {
+    quint32 parent;
+    quint32 first_child;
+    quint32 child_count;
+    quint32 name_offset;
+    quint32 name_size;
+    quint16 A;
+    quint16 Z;
+    quint8 type;
+    quint8 selectable;
+    quint16 reserved;
+  };
+
+  ENSDFTreeCache() {}
+  ~ENSDFTreeCache();
+  ENSDFTreeCache(const ENSDFTreeCache&) = delete;
+  ENSDFTreeCache& operator=(const ENSDFTreeCache&) = delete;
+
+  bool open(const QString &path);
+  void close();
+  bool isOpen() const;
+
+  quint32 nodeCount() const;
+  const Node &node(quint32 idx) const;
+  /// false if a corrupt file points the children outside the node table
+  bool childrenInRange(quint32 idx) const;
+  QString name(quint32 idx) const;
+  NuclideId id(quint32 idx) const;
+
+  QMap<uint16_t, FileSignature> signatures() const;
+
+  static bool write(const QString &path,
+                    ENSDFTreeItem &root,
+                    const QMap<uint16_t, FileSignature> &signatures);
+
+private:
+  struct Header
+  {
+    quint32 magic;
+    quint32 version;
+    quint32 chain_count;
+    quint32 node_count;
+    quint32 string_size;
+    quint32 reserved;
+  };
+
+  struct ChainRecord
+  {
+    quint16 A;
+    quint16 hash_size;
+    quint32 reserved;
+    qint64 size;
+    qint64 modified;
+    char hash[24];
+  };
+
+  static const quint32 magicNumber;
+  static const quint32 cacheVersion;
+
+  QFile file_;
+  const uchar *data_ {nullptr};
+  const Header *header_ {nullptr};
+  const ChainRecord *chains_ {nullptr};
+  const Node *nodes_ {nullptr};
+  const char *strings_ {nullptr};
+};
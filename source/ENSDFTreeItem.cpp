@@ -1,4 +1,5 @@
 #include "ENSDFTreeItem.h"
+#include "ENSDFTreeCache.h"
 
 #include <QVariant>
 
@@ -21,9 +22,23 @@ ENSDFTreeItem::ENSDFTreeItem(ItemType type,
   setParent(parent);
 }
 
+ENSDFTreeItem::ENSDFTreeItem(const ENSDFTreeCache *cache,
+                             quint32 node,
+                             ENSDFTreeItem *parent)
+  : nid(cache->id(node)),
+    parentItem(parent),
+    m_isSelectable(cache->node(node).selectable),
+    m_type(ItemType(cache->node(node).type)),
+    m_cache(cache), m_node(node)
+{
+  setParent(parent);
+}
+
 ENSDFTreeItem::ENSDFTreeItem(const ENSDFTreeItem &original)
   : nid(original.nid), itemData(original.itemData), m_isSelectable(original.m_isSelectable), m_type(original.m_type)
 {
+  if (original.m_cache)
+    itemData = QList<QVariant>() << original.data(0);
 }
 
 ENSDFTreeItem::~ENSDFTreeItem()
@@ -38,19 +53,36 @@ ENSDFTreeItem *ENSDFTreeItem::parent() const
 
 ENSDFTreeItem *ENSDFTreeItem::child(int row)
 {
+  loadChildren();
   return childItems.value(row);
 }
 
 int ENSDFTreeItem::childCount() const
 {
+  if (m_cache && !m_childrenLoaded)
+    return m_cache->childrenInRange(m_node) ? int(m_cache->node(m_node).child_count) : 0;
   return childItems.count();
 }
 
 int ENSDFTreeItem::columnCount() const
 {
+  if (m_cache)
+    return 1;
   return itemData.count();
 }
 
+void ENSDFTreeItem::loadChildren()
+{
+  if (!m_cache || m_childrenLoaded)
+    return;
+  m_childrenLoaded = true;
+  if (!m_cache->childrenInRange(m_node))
+    return;
+  const ENSDFTreeCache::Node &n = m_cache->node(m_node);
+  for (quint32 i=0; i < n.child_count; ++i)
+    new ENSDFTreeItem(m_cache, n.first_child + i, this);
+}
+
 bool ENSDFTreeItem::hasParent() const
 {
   return parentItem;
@@ -63,6 +95,23 @@ void ENSDFTreeItem::setParent(ENSDFTreeItem *parent)
     parent->childItems.append(this);
 }
 
+void ENSDFTreeItem::insertChild(int row, ENSDFTreeItem *child)
+{
+  loadChildren();
+  child->parentItem = this;
+  childItems.insert(row, child);
+}
+
+ENSDFTreeItem *ENSDFTreeItem::takeChild(int row)
+{
+  loadChildren();
+  if ((row < 0) || (row >= childItems.size()))
+    return nullptr;
+  ENSDFTreeItem *child = childItems.takeAt(row);
+  child->parentItem = nullptr;
+  return child;
+}
+
 void ENSDFTreeItem::setItemData(const QList<QVariant> &data)
 {
   itemData = data;
@@ -80,11 +129,19 @@ bool ENSDFTreeItem::isSelectable() const
 
 QVariant ENSDFTreeItem::data(int column) const
 {
+  if (m_cache)
+    return column ? QVariant() : QVariant(m_cache->name(m_node));
   return itemData.value(column);
 }
 
 int ENSDFTreeItem::row() const
 {
+  if (m_cache && parentItem && parentItem->m_cache)
+  {
+    int r = int(m_node - m_cache->node(parentItem->m_node).first_child);
+    if (parentItem->childItems.value(r) == this)
+      return r;
+  }
   if (parentItem)
     return parentItem->childItems.indexOf(const_cast<ENSDFTreeItem*>(this));
   return 0;
@@ -94,43 +151,3 @@ ENSDFTreeItem::ItemType ENSDFTreeItem::type() const
 {
   return m_type;
 }
-
-QDataStream & operator <<(QDataStream &out, const ENSDFTreeItem &treeitem)
-{
-  out << treeitem.itemData;
-  out << treeitem.nid.A();
-  out << treeitem.nid.Z();
-  out << treeitem.m_isSelectable;
-  out << int(treeitem.m_type);
-  out << quint32(treeitem.childItems.size());
-  foreach (const ENSDFTreeItem *it, treeitem.childItems)
-  {
-    const ENSDFTreeItem *eit = dynamic_cast<const ENSDFTreeItem*>(it);
-    if (eit)
-      out << (*eit);
-  }
-  return out;
-}
-
-
-QDataStream & operator >>(QDataStream &in, ENSDFTreeItem &treeitem)
-{
-  uint16_t a, z;
-  in >> treeitem.itemData;
-  in >> a;
-  in >> z;
-  treeitem.nid = NuclideId::fromAZ(a, z);
-  in >> treeitem.m_isSelectable;
-  int type;
-  in >> type;
-  treeitem.m_type = ENSDFTreeItem::ItemType(type);
-  quint32 numchildren;
-  in >> numchildren;
-  for (quint32 i=0; i<numchildren; i++)
-  {
-    ENSDFTreeItem *childitem = new ENSDFTreeItem(ENSDFTreeItem::UnknownType, &treeitem);
-    in >> (*childitem);
-  }
-  return in;
-}
-
@@ -4,10 +4,11 @@
 #include <QStringList>
 #include <QSharedPointer>
 #include <QMetaType>
-#include <QDataStream>
 
 #include <NucData/DecayScheme.h>
 
+class ENSDFTreeCache;
+
 class ENSDFTreeItem
 {
 public:
@@ -27,6 +28,13 @@ public:
                          const QList<QVariant> &data,
                          bool selectable,
                          ENSDFTreeItem *parent = 0);
+  /**
+     * @brief Creates an item backed by a node of the memory-mapped cache.
+     *  Its children are only instantiated when first accessed.
+     */
+  explicit ENSDFTreeItem(const ENSDFTreeCache *cache,
+                         quint32 node,
+                         ENSDFTreeItem *parent = 0);
   /**
      * @brief This copy constructor creates a standalone copy without links to parent or children
      * @param original
@@ -42,6 +50,8 @@ public:
   bool hasParent() const;
 
   void setParent(ENSDFTreeItem *parent);
+  void insertChild(int row, ENSDFTreeItem *child);
+  ENSDFTreeItem *takeChild(int row);
   void setItemData(const QList<QVariant> &data);
 
   void setSelectable(bool selectable);
@@ -54,16 +64,24 @@ public:
   NuclideId id() const { return nid; }
   ItemType type() const;
 
-  friend QDataStream & operator<<(QDataStream &out, const ENSDFTreeItem &treeitem);
-  friend QDataStream & operator>>(QDataStream &in, ENSDFTreeItem &treeitem);
+  /// the cache node behind this item, if any
+  const ENSDFTreeCache *cache() const { return m_cache; }
+  quint32 cacheNode() const { return m_node; }
+  /// false while the children are only in the cache
+  bool childrenLoaded() const { return m_childrenLoaded; }
 
 protected:
+  void loadChildren();
+
   NuclideId nid;
   QList<ENSDFTreeItem*> childItems;
   QList<QVariant> itemData;
   ENSDFTreeItem *parentItem;
   bool m_isSelectable;
   ItemType m_type;
+  const ENSDFTreeCache *m_cache {nullptr};
+  quint32 m_node {0};
+  bool m_childrenLoaded {false};
 };
 
 Q_DECLARE_METATYPE(ENSDFTreeItem)
@@ -0,0 +1,218 @@
+#include <NucData/CascadeClosure.h>
+
+#include <istream>
+#include <ostream>
+#include <cmath>
+
+CascadeClosure::CascadeClosure(const Nuclide& nuclide)
+{
+  auto levels = nuclide.levels();
+  auto transitions = nuclide.transitions();
+
+  std::map<Energy, uint32_t> level_idx;
+  for (const auto& l : levels)
+  {
+    level_idx[l.first] = uint32_t(halflife_.size());
+    const auto& hl = l.second.halfLife();
+    halflife_.push_back(hl.valid() ? hl.seconds() : kDoubleNaN);
+  }
+
+  auto find_level = [&](const Energy& e)
+  {
+    auto it = level_idx.find(e);
+    return (it == level_idx.end()) ? none : it->second;
+  };
+
+  std::vector<uint32_t> depop_count(levels.size(), 0);
+  for (const auto& t : transitions)
+  {
+    from_.push_back(find_level(t.second.from()));
+    to_.push_back(find_level(t.second.to()));
+    if (from_.back() != none)
+      ++depop_count[from_.back()];
+  }
+
+  depop_first_.assign(levels.size() + 1, 0);
+  for (size_t l = 0; l < levels.size(); ++l)
+    depop_first_[l + 1] = depop_first_[l] + depop_count[l];
+  depop_.resize(depop_first_.back());
+  std::vector<uint32_t> fill(depop_first_.begin(), depop_first_.end() - 1);
+  for (uint32_t t = 0; t < from_.size(); ++t)
+    if (from_[t] != none)
+      depop_[fill[from_[t]]++] = t;
+
+  // levels in ascending energy, so the levels below are usually closed first
+  below_.assign(levels.size() * words(), 0);
+  std::vector<uint8_t> state(levels.size(), 0);
+  for (uint32_t l = 0; l < levels.size(); ++l)
+    close(l, state);
+}
+
+size_t CascadeClosure::words() const
+{
+  return (from_.size() + 63) / 64;
+}
+
+void CascadeClosure::close(uint32_t level, std::vector<uint8_t>& state)
+{
+  // 0 = open, 1 = in progress (guards against loops in odd data), 2 = closed
+  if (state[level])
+    return;
+  state[level] = 1;
+
+  const size_t w = words();
+  uint64_t* bits = below_.data() + level * w;
+  for (uint32_t i = depop_first_[level]; i < depop_first_[level + 1]; ++i)
+  {
+    uint32_t t = depop_[i];
+    bits[t / 64] |= uint64_t(1) << (t % 64);
+    uint32_t next = to_[t];
+    if ((next == none) || (next == level))
+      continue;
+    close(next, state);
+    const uint64_t* nb = below_.data() + next * w;
+    for (size_t k = 0; k < w; ++k)
+      bits[k] |= nb[k];
+  }
+  state[level] = 2;
+}
+
+bool CascadeClosure::test(uint32_t level, uint32_t transition) const
+{
+  return (below_[level * words() + transition / 64]
+      >> (transition % 64)) & 1;
+}
+
+bool CascadeClosure::follows(uint32_t a, uint32_t b) const
+{
+  if ((a >= to_.size()) || (b >= to_.size()) || (to_[a] == none))
+    return false;
+  return test(to_[a], b);
+}
+
+bool CascadeClosure::coincident(uint32_t a, uint32_t b) const
+{
+  return follows(a, b) || follows(b, a);
+}
+
+bool CascadeClosure::follows(uint32_t a, uint32_t b, double max_halflife) const
+{
+  // the closure bits decide cheaply whether a path exists at all
+  if (!follows(a, b))
+    return false;
+  if (!std::isfinite(max_halflife))
+    return true;
+
+  auto prompt = [&](uint32_t level)
+  {
+    return !(halflife_[level] > max_halflife);
+  };
+
+  // walk down through prompt levels only, pruning branches that cannot reach b
+  std::vector<uint8_t> visited(halflife_.size(), 0);
+  std::vector<uint32_t> stack {to_[a]};
+  while (!stack.empty())
+  {
+    uint32_t level = stack.back();
+    stack.pop_back();
+    if (visited[level] || !prompt(level) || !test(level, b))
+      continue;
+    visited[level] = 1;
+    for (uint32_t i = depop_first_[level]; i < depop_first_[level + 1]; ++i)
+    {
+      uint32_t t = depop_[i];
+      if (t == b)
+        return true;
+      if (to_[t] != none)
+        stack.push_back(to_[t]);
+    }
+  }
+  return false;
+}
+
+bool CascadeClosure::coincident(uint32_t a, uint32_t b, double max_halflife) const
+{
+  return follows(a, b, max_halflife) || follows(b, a, max_halflife);
+}
+
+std::vector<uint64_t> CascadeClosure::coincidence_rows() const
+{
+  const size_t w = words();
+  std::vector<uint64_t> rows(from_.size() * w, 0);
+  for (uint32_t a = 0; a < from_.size(); ++a)
+  {
+    if (to_[a] == none)
+      continue;
+    // a precedes everything below its final level, and those follow a
+    const uint64_t* below = below_.data() + to_[a] * w;
+    uint64_t* row = rows.data() + a * w;
+    for (size_t k = 0; k < w; ++k)
+    {
+      if (!below[k])
+        continue;
+      row[k] |= below[k];
+      for (uint32_t i = 0; i < 64; ++i)
+        if ((below[k] >> i) & 1)
+          rows[(k * 64 + i) * w + a / 64] |= uint64_t(1) << (a % 64);
+    }
+  }
+  return rows;
+}
+
+template <typename T>
+static void write_vector(std::ostream& os, const std::vector<T>& v)
+{
+  uint32_t size = uint32_t(v.size());
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(reinterpret_cast<const char*>(v.data()),
+           std::streamsize(v.size() * sizeof(T)));
+}
+
+template <typename T>
+static bool read_vector(std::istream& is, std::vector<T>& v)
+{
+  uint32_t size {0};
+  if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+      (size > (1u << 28)))
+    return false;
+  v.resize(size);
+  return bool(is.read(reinterpret_cast<char*>(v.data()),
+                      std::streamsize(size * sizeof(T))));
+}
+
+void CascadeClosure::write(std::ostream& os) const
+{
+  write_vector(os, from_);
+  write_vector(os, to_);
+  write_vector(os, halflife_);
+  write_vector(os, depop_first_);
+  write_vector(os, depop_);
+  write_vector(os, below_);
+}
+
+bool CascadeClosure::read(std::istream& is)
+{
+  if (!read_vector(is, from_) || !read_vector(is, to_) ||
+      !read_vector(is, halflife_) || !read_vector(is, depop_first_) ||
+      !read_vector(is, depop_) || !read_vector(is, below_))
+    return false;
+
+  // reject tables that do not fit together
+  const size_t levels = halflife_.size();
+  if ((to_.size() != from_.size()) ||
+      (depop_first_.size() != levels + 1) ||
+      (depop_first_.back() != depop_.size()) ||
+      (below_.size() != levels * words()))
+    return false;
+  for (size_t t = 0; t < from_.size(); ++t)
+    if (((from_[t] != none) && (from_[t] >= levels)) ||
+        ((to_[t] != none) && (to_[t] >= levels)))
+      return false;
+  for (auto t : depop_)
+    if (t >= from_.size())
+      return false;
+  for (size_t l = 0; l < levels; ++l)
+    if (depop_first_[l] > depop_first_[l + 1])
+      return false;
+  return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <NucData/Nuclide.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * @brief Precomputed gamma cascades of one nuclide.
+ *
+ * Transitions and levels are numbered in the order of Nuclide::transitions()
+ * and Nuclide::levels(). For every level a bitset over transitions marks
+ * all transitions that can follow once the level is populated, so two
+ * transitions are in coincidence if one is set in the bitset of the level
+ * the other one feeds.
+ */
+class CascadeClosure
+{
+public:
+  static constexpr uint32_t none = UINT32_MAX;
+
+  CascadeClosure() {}
+  explicit CascadeClosure(const Nuclide& nuclide);
+
+  size_t transition_count() const { return from_.size(); }
+  size_t level_count() const { return halflife_.size(); }
+
+  // b follows a somewhere below a's final level
+  bool follows(uint32_t a, uint32_t b) const;
+  bool coincident(uint32_t a, uint32_t b) const;
+
+  // as above, but the cascade may only pass through intermediate levels
+  // with half-lives up to max_halflife seconds (unknown counts as prompt)
+  bool follows(uint32_t a, uint32_t b, double max_halflife) const;
+  bool coincident(uint32_t a, uint32_t b, double max_halflife) const;
+
+  // words per transition bitset
+  size_t words() const;
+  // for every transition, words() words marking the transitions in coincidence
+  std::vector<uint64_t> coincidence_rows() const;
+
+  void write(std::ostream& os) const;
+  bool read(std::istream& is);
+
+private:
+  std::vector<uint32_t> from_;         // per transition: initial level
+  std::vector<uint32_t> to_;           // per transition: final level
+  std::vector<double> halflife_;       // per level: seconds
+  std::vector<uint32_t> depop_first_;  // per level + 1: offsets into depop_
+  std::vector<uint32_t> depop_;        // transitions grouped by initial level
+  std::vector<uint64_t> below_;        // per level: words() words of transition bits
+
+  bool test(uint32_t level, uint32_t transition) const;
+  void close(uint32_t level, std::vector<uint8_t>& state);
+};
@@ -51,7 +51,7 @@ Reaction::Reaction(std::string s, NuclideId daughter)
                          boost::regex(RGX_REACTION_PARSE))
       && (what.size() > 2))
   {
-    target = parse_nid(what[1]);
+    target = parse_nid(what[1].str());
     if (!target.composition_known() && target.Z())
       target.set_A(daughter.A());
 
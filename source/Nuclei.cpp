@@ -12,6 +12,14 @@
 #include <qguiapplication.h>
 #include <qscreen.h>
 #include <util/logger.h>
+#include <util/trace.h>
+#include <ensdf/Fields.h>
+#include <search/ActivationSearch.h>
+#include <search/CoincidenceSearch.h>
+#include <search/FingerprintSearch.h>
+
+#include <chrono>
+#include <cmath>
 
 Nuclei::Nuclei(QWidget *parent)
   : QMainWindow(parent)
@@ -52,6 +60,9 @@ Nuclei::~Nuclei()
 
   delete preferencesDialogUi;
   delete ui;
+
+  // write out what is still queued for the log
+  CustomLogger::closeLogger();
 }
 
 void Nuclei::initialize()
@@ -86,18 +97,23 @@ void Nuclei::initialize()
 
   decaySelectionModel = new DecayCascadeItemModel(data_source_, this);
   decayProxyModel = new DecayCascadeFilterProxyModel(this);
-  decayProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
-  connect(ui->decayFilterLineEdit, SIGNAL(textChanged(QString)), decayProxyModel, SLOT(setFilterWildcard(QString)));
+  connect(ui->decayFilterLineEdit, SIGNAL(textChanged(QString)), decayProxyModel, SLOT(setFilterText(QString)));
   decayProxyModel->setSourceModel(decaySelectionModel);
   ui->decayTreeView->setModel(decayProxyModel);
   connect(ui->decayTreeView, SIGNAL(showItem(QModelIndex)), this, SLOT(loadSelectedDecay(QModelIndex)));
 
-  searchResultSelectionModel = new DecayCascadeItemModel(0, this);
+  searchResultSelectionModel = new DecayCascadeItemModel(data_source_, this);
+  searchResultSelectionModel->setResults(data_source_->resultsTree({}, "Lines"));
   searchProxyModel = new DecayCascadeFilterProxyModel(this);
-  searchProxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
   searchProxyModel->setSourceModel(searchResultSelectionModel);
+  ui->searchTreeView->setModel(searchProxyModel);
+  connect(ui->searchTreeView, SIGNAL(showItem(QModelIndex)), this, SLOT(loadSearchResultCascade(QModelIndex)));
+  connect(ui->minAbundanceSpin, SIGNAL(valueChanged(double)), this, SLOT(refreshActivationSearch()));
+  connect(ui->stableTargetCheck, SIGNAL(toggled(bool)), this, SLOT(refreshActivationSearch()));
+  connect(ui->irradiationEdit, SIGNAL(editingFinished()), this, SLOT(refreshActivationSearch()));
 
   ui->decayFilterLineEdit->setText(s.value("decayFilter", "").toString());
+  decayProxyModel->applyFilter(); // the saved selection refers to the filtered tree
   QList<QVariant> selectionIndices(s.value("decaySelection").toList());
   if (!selectionIndices.isEmpty()) {
     QModelIndex mi = decayProxyModel->index(selectionIndices.at(0).toInt(), 0);
@@ -110,6 +126,7 @@ void Nuclei::initialize()
 
 void Nuclei::loadSelectedDecay(const QModelIndex &index)
 {
+  TRACE_SCOPE("Nuclei::loadSelectedDecay");
   if (!index.isValid())
     return;
 
@@ -123,6 +140,7 @@ void Nuclei::loadSelectedDecay(const QModelIndex &index)
 
 void Nuclei::loadSearchResultCascade(const QModelIndex &index)
 {
+  TRACE_SCOPE("Nuclei::loadSearchResultCascade");
   if (!index.isValid())
     return;
 
@@ -133,6 +151,180 @@ void Nuclei::loadSearchResultCascade(const QModelIndex &index)
                                                                   preferencesDialogUi->checkMergeAdopted->isChecked()));
 }
 
+static double halflife_seconds(const QString &text, double fallback)
+{
+  if (text.trimmed().isEmpty())
+    return fallback;
+  HalfLife hl = parse_halflife(text.toStdString());
+  if (!hl.valid() || std::isnan(hl.seconds()))
+    return fallback;
+  return hl.seconds();
+}
+
+void Nuclei::on_gammaSearchButton_clicked()
+{
+  if (!data_source_)
+    return;
+
+  GammaIndex::Query q;
+  q.energy = ui->gammaEnergySpin->value();
+  q.tolerance = ui->gammaToleranceSpin->value();
+  q.min_intensity = ui->gammaIntensitySpin->value();
+  q.min_halflife = halflife_seconds(ui->halfLifeMinEdit->text(), 0);
+  q.max_halflife = halflife_seconds(ui->halfLifeMaxEdit->text(), kDoubleInf);
+
+  const GammaIndex &index = data_source_->gammaIndex();
+  auto start = std::chrono::steady_clock::now();
+  auto hits = index.find(q);
+  auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+  DBG("<Nuclei> Gamma search {}±{} keV: {} lines in {:.1f} us",
+      q.energy, q.tolerance, hits.size(), elapsed.count());
+
+  // one result per decay, listing all of its matching lines
+  QMap<quint32, QString> lines;
+  for (auto h : hits)
+  {
+    const auto &l = index.line(h);
+    QString &text = lines[l.dataset];
+    if (!text.isEmpty())
+      text += ", ";
+    text += QString::number(l.energy) + " keV";
+    if (!std::isnan(l.intensity))
+      text += " (" + QString::number(l.intensity) + "%)";
+  }
+
+  QList<QPair<quint32, QString>> results;
+  for (auto it = lines.begin(); it != lines.end(); ++it)
+    results.append(qMakePair(it.key(), it.value()));
+  activationResults = false;
+  searchResultSelectionModel->setResults(data_source_->resultsTree(results, "Lines"));
+  ui->searchTreeView->expandAll();
+  ui->searchTreeView->resizeColumnToContents(0);
+}
+
+void Nuclei::on_fingerprintButton_clicked()
+{
+  if (!data_source_)
+    return;
+
+  FingerprintSearch::Query q;
+  q.peaks = FingerprintSearch::parse_peaks(ui->peaksEdit->toPlainText().toStdString(),
+                                           ui->gammaToleranceSpin->value());
+  q.min_matched = size_t(ui->minMatchedSpin->value());
+  q.min_halflife = halflife_seconds(ui->halfLifeMinEdit->text(), 0);
+  q.max_halflife = halflife_seconds(ui->halfLifeMaxEdit->text(), kDoubleInf);
+  if (q.peaks.empty())
+    return;
+
+  FingerprintSearch search(data_source_->gammaIndex());
+  auto start = std::chrono::steady_clock::now();
+  auto matches = search.search(q);
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+  DBG("<Nuclei> Fingerprint search of {} peaks: {} decays in {:.2f} ms",
+      q.peaks.size(), matches.size(), elapsed.count());
+
+  QList<QPair<quint32, QString>> results;
+  for (const auto &m : matches)
+    results.append(qMakePair(m.dataset,
+                             QString("%1/%2 peaks, %3% of intensity")
+                             .arg(m.peaks.count()).arg(q.peaks.size())
+                             .arg(m.coverage * 100.0, 0, 'f', 1)));
+  activationResults = false;
+  searchResultSelectionModel->setResults(data_source_->resultsTree(results, "Match", false));
+  ui->searchTreeView->resizeColumnToContents(0);
+}
+
+void Nuclei::on_coincidenceButton_clicked()
+{
+  if (!data_source_)
+    return;
+
+  CoincidenceSearch::Query q;
+  q.energy1 = ui->gammaEnergySpin->value();
+  q.energy2 = ui->coincidenceEnergySpin->value();
+  q.tolerance = ui->gammaToleranceSpin->value();
+  q.min_intensity = ui->gammaIntensitySpin->value();
+  q.max_level_halflife = halflife_seconds(ui->levelHalfLifeEdit->text(), kDoubleInf);
+  q.min_halflife = halflife_seconds(ui->halfLifeMinEdit->text(), 0);
+  q.max_halflife = halflife_seconds(ui->halfLifeMaxEdit->text(), kDoubleInf);
+
+  const GammaIndex &index = data_source_->gammaIndex();
+  CoincidenceSearch search(index);
+  auto start = std::chrono::steady_clock::now();
+  auto matches = search.search(q);
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+  DBG("<Nuclei> Coincidence search {}+{} keV: {} decays in {:.2f} ms",
+      q.energy1, q.energy2, matches.size(), elapsed.count());
+
+  auto describe = [](const GammaIndex::Line &l)
+  {
+    QString text = QString::number(l.energy) + " keV";
+    if (!std::isnan(l.intensity))
+      text += " (" + QString::number(l.intensity) + "%)";
+    return text;
+  };
+
+  QList<QPair<quint32, QString>> results;
+  for (const auto &m : matches)
+    results.append(qMakePair(m.dataset,
+                             describe(index.line(m.line1)) + " + "
+                             + describe(index.line(m.line2))));
+  activationResults = false;
+  searchResultSelectionModel->setResults(data_source_->resultsTree(results, "Cascade", false));
+  ui->searchTreeView->resizeColumnToContents(0);
+}
+
+void Nuclei::on_activationButton_clicked()
+{
+  if (!data_source_)
+    return;
+
+  ActivationSearch::Query q;
+  if (ui->gammaEnergySpin->value() > 0)
+  {
+    q.min_energy = ui->gammaEnergySpin->value() - ui->gammaToleranceSpin->value();
+    q.max_energy = ui->gammaEnergySpin->value() + ui->gammaToleranceSpin->value();
+  }
+  q.min_intensity = ui->gammaIntensitySpin->value();
+  q.min_abundance = ui->minAbundanceSpin->value();
+  q.stable_target = ui->stableTargetCheck->isChecked();
+  q.irradiation = halflife_seconds(ui->irradiationEdit->text(), q.irradiation);
+  q.min_halflife = halflife_seconds(ui->halfLifeMinEdit->text(), 0);
+  q.max_halflife = halflife_seconds(ui->halfLifeMaxEdit->text(), kDoubleInf);
+
+  const GammaIndex &index = data_source_->gammaIndex();
+  const NuclideTable &nuclides = data_source_->nuclideTable();
+  auto start = std::chrono::steady_clock::now();
+  auto matches = data_source_->activationSearch().search(q);
+  auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+  DBG("<Nuclei> Activation search: {} products in {:.2f} ms",
+      matches.size(), elapsed.count());
+
+  QList<QPair<quint32, QString>> results;
+  for (const auto &m : matches)
+  {
+    const auto &l = index.line(m.line);
+    QString text = QString::fromStdString(nuclides.id(m.target).symbolicName())
+        + " (" + QString::number(nuclides.abundance(m.target)) + "%";
+    if (!std::isnan(nuclides.capture(m.target)))
+      text += ", " + QString::number(nuclides.capture(m.target)) + " b";
+    text += "), " + QString::number(l.energy) + " keV";
+    if (!std::isnan(l.intensity))
+      text += " (" + QString::number(l.intensity) + "%)";
+    results.append(qMakePair(m.dataset, text));
+  }
+  searchResultSelectionModel->setResults(data_source_->resultsTree(results, "Target, line", false));
+  ui->searchTreeView->resizeColumnToContents(0);
+  activationResults = true;
+}
+
+void Nuclei::refreshActivationSearch()
+{
+  // filters apply live once activation products are listed
+  if (activationResults)
+    on_activationButton_clicked();
+}
+
 void Nuclei::closeEvent(QCloseEvent *event)
 {
   QSettings s;
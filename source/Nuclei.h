@@ -32,6 +32,11 @@ private slots:
   void loadSearchResultCascade(const QModelIndex &index);
 
   void on_decayOptionsButton_clicked();
+  void on_gammaSearchButton_clicked();
+  void on_fingerprintButton_clicked();
+  void on_coincidenceButton_clicked();
+  void on_activationButton_clicked();
+  void refreshActivationSearch();
 
 protected:
   void closeEvent(QCloseEvent * event);
@@ -47,6 +52,7 @@ private:
   DecayCascadeFilterProxyModel *searchProxyModel {nullptr};
 
   QPointer<ENSDFDataSource> data_source_;
+  bool activationResults {false};
 
   void reload_selection();
 };
@@ -4,6 +4,7 @@
 #include <QParallelAnimationGroup>
 #include <QPropertyAnimation>
 #include <QGraphicsSceneMouseEvent>
+#include <QGraphicsTextItem>
 #include "GraphicsHighlightItem.h"
 #include "GraphicsDropShadowEffect.h"
 #include "ClickableItem.h"
@@ -172,7 +173,7 @@ void ActiveGraphicsItemGroup::showHighlighting()
   else if (highlight_helper_ && shadow_)
   {
     highlight_helper_->show();
-    shadow_->setEnabled(true && shadow_enabled_);
+    shadow_->setEnabled(shadow_enabled_ && detailed_);
   }
 
   if (highlighted_ && active_colors_.count(highlighted_))
@@ -242,6 +243,29 @@ void ActiveGraphicsItemGroup::setShadowEnabled(bool enable)
 {
   if (enable != shadow_enabled_) {
     shadow_enabled_ = enable;
-    shadow_->setEnabled(enable && (highlighted_ || hovering_));
+    shadow_->setEnabled(enable && detailed_ && (highlighted_ || hovering_));
   }
 }
+
+void ActiveGraphicsItemGroup::setDetailed(bool detailed)
+{
+  if (detailed == detailed_)
+    return;
+  detailed_ = detailed;
+
+  for (auto i : childItems())
+    if ((i->type() == QGraphicsSimpleTextItem::Type)
+        || (i->type() == QGraphicsTextItem::Type))
+      i->setVisible(detailed);
+
+  setAcceptHoverEvents(detailed);
+  if (!detailed && hovering_)
+  {
+    hovering_ = false;
+    if (highlighted_)
+      updateHighlightColor();
+    else
+      hideHighlighting();
+  }
+  shadow_->setEnabled(shadow_enabled_ && detailed_ && (highlighted_ || hovering_));
+}
@@ -31,6 +31,8 @@ signals:
 
 public slots:
     void setShadowEnabled(bool enable);
+    // hides labels and hover feedback when zoomed out too far to read them
+    void setDetailed(bool detailed);
 
 protected:
     virtual void hoverEnterEvent(QGraphicsSceneHoverEvent * event);
@@ -50,6 +52,7 @@ private:
     int highlighted_ {0};
     bool hovering_ {false};
     bool shadow_enabled_ {true};
+    bool detailed_ {true};
 
     QPropertyAnimation *highlight_animation_ {nullptr};
     QPropertyAnimation *shadow_animation_ {nullptr};
@@ -1,5 +1,6 @@
 #include "ClickableItem.h"
 #include "ActiveGraphicsItemGroup.h"
+#include "SchemeVisualSettings.h"
 
 ClickableItem::ClickableItem(Type type)
   :t(type) {}
@@ -13,3 +14,13 @@ ActiveGraphicsItemGroup *ClickableItem::graphicsItem() const
 {
   return item;
 }
+
+void ClickableItem::setColors(const QColor &normal, const SchemeVisualSettings &vis)
+{
+  item->setActiveColor(0, normal);
+  item->setActiveColor(1, vis.selected_color());
+  item->setActiveColor(2, vis.implicated_color());
+  item->setHoverColor(vis.hover_color());
+  // repaint with the new colors
+  item->setHighlighted(item->isHighlighted());
+}
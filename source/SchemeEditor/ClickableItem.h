@@ -2,6 +2,8 @@
 
 class ActiveGraphicsItemGroup;
 class QGraphicsItem;
+class QColor;
+struct SchemeVisualSettings;
 
 class ClickableItem
 {
@@ -25,4 +27,7 @@ public:
 protected:
   ActiveGraphicsItemGroup *item {nullptr};
   Type t {InvalidType};
+
+  // normal color plus the selection colors of the style
+  void setColors(const QColor &normal, const SchemeVisualSettings &vis);
 };
@@ -0,0 +1,120 @@
+#include "ColumnPacker.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+
+// Tops of the columns in a min-tree, so that the first column free below
+// a height is found in O(log n). Columns past the end are empty.
+class ColumnTops
+{
+public:
+  double at(int c) const
+  {
+    return (c < leaves_) ? tree_[leaves_ + c] : empty;
+  }
+
+  void raise(int c, double y)
+  {
+    while (c >= leaves_)
+      grow();
+    int i = leaves_ + c;
+    if (!(y > tree_[i]))
+      return;
+    tree_[i] = y;
+    for (i /= 2; i >= 1; i /= 2)
+      tree_[i] = std::min(tree_[2 * i], tree_[2 * i + 1]);
+  }
+
+  // first column from c on whose top is not above y
+  int first_free(int c, double y) const
+  {
+    if (c >= leaves_)
+      return c;
+    int i = leaves_ + c;
+    if (!(tree_[i] > y))
+      return c;
+    // climb until a right sibling holds a free column, then descend to it
+    while (true)
+    {
+      if (i == 1)
+        return leaves_;
+      if ((i % 2 == 0) && !(tree_[i + 1] > y))
+      {
+        i = i + 1;
+        break;
+      }
+      i /= 2;
+    }
+    while (i < leaves_)
+      i = (tree_[2 * i] > y) ? 2 * i + 1 : 2 * i;
+    return i - leaves_;
+  }
+
+private:
+  static constexpr double empty = -std::numeric_limits<double>::infinity();
+
+  int leaves_ {0};
+  std::vector<double> tree_;
+
+  void grow()
+  {
+    int leaves = std::max(16, 2 * leaves_);
+    std::vector<double> tree(2 * leaves, empty);
+    std::copy(tree_.begin() + leaves_, tree_.end(), tree.begin() + leaves);
+    for (int i = leaves - 1; i >= 1; --i)
+      tree[i] = std::min(tree[2 * i], tree[2 * i + 1]);
+    leaves_ = leaves;
+    tree_.swap(tree);
+  }
+};
+
+}
+
+std::vector<int> packColumns(const std::vector<ColumnFootprint>& footprints,
+                             double pitch, double step)
+{
+  std::vector<int> columns(footprints.size(), 0);
+  if (footprints.empty() || !(pitch > 0) || !(step > 0))
+    return columns;
+
+  std::vector<size_t> order(footprints.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&footprints](size_t a, size_t b)
+  {
+    return footprints[a].low < footprints[b].low;
+  });
+
+  ColumnTops tops;
+  for (auto i : order)
+  {
+    const auto& f = footprints[i];
+
+    // columns on the right crossed by the label
+    int reach = 0;
+    while (f.base + (reach + 0.5) * step < f.high)
+      ++reach;
+
+    auto label_fits = [&](int c)
+    {
+      for (int k = 1; (k <= reach) && (k <= c); ++k)
+        if (tops.at(c - k) > f.base + (k - 0.5) * step)
+          return false;
+      return true;
+    };
+
+    int c = tops.first_free(0, f.low);
+    while (!label_fits(c))
+      c = tops.first_free(c + 1, f.low);
+
+    columns[i] = c;
+    tops.raise(c, std::max(f.base, std::min(f.high, f.base + 0.5 * step)));
+    for (int k = 1; (k <= reach) && (k <= c); ++k)
+      tops.raise(c - k, std::min(f.high, f.base + (k + 0.5) * step));
+  }
+  return columns;
+}
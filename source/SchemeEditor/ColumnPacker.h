@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+// Vertical extent of a transition, upwards from the bottom of the scheme
+struct ColumnFootprint
+{
+  double low {0};   // lower level, where the arrow ends
+  double base {0};  // upper level, where the label starts
+  double high {0};  // top of the label
+};
+
+// Packs transitions into shared columns, numbered from the right, and
+// returns the column of each. Columns are pitch apart, and a slanted label
+// climbs step for each column it crosses on its right.
+//
+// Greedy interval partitioning: taken by their lower ends, each transition
+// goes to the first column that is free above it and whose neighbours on
+// the right are free where its label crosses them. Free columns are kept
+// ordered by number and the others by the top of what they hold, so a
+// transition costs O(log n), plus a label check for each free column it
+// has to pass over. Qt-free, so that it can be benchmarked on its own.
+std::vector<int> packColumns(const std::vector<ColumnFootprint>& footprints,
+                             double pitch, double step);
@@ -1,7 +1,7 @@
 #include "LevelItem.h"
 #include "ActiveGraphicsItemGroup.h"
 #include "GraphicsHighlightItem.h"
-#include <QFontMetrics>
+#include "SchemeStyle.h"
 #include <QTextItem>
 #include <QGraphicsScene>
 #include <QTextDocument>
@@ -9,7 +9,7 @@
 
 
 FeedingArrow::FeedingArrow(Level level, ParentPosition parentpos,
-                           SchemeVisualSettings vis,
+                           const SchemeVisualSettings& vis,
                            QGraphicsScene *scene)
 {
   if (level.normalizedFeedIntensity().uncertaintyType()
@@ -18,12 +18,10 @@ FeedingArrow::FeedingArrow(Level level, ParentPosition parentpos,
 
   t = FeedingType;
   energy_ = level.energy();
+  parentpos_ = parentpos;
 
   item = new ActiveGraphicsItemGroup(this);
-  item->setActiveColor(0, vis.inactive_color());
-  item->setActiveColor(1, vis.selected_color());
-  item->setActiveColor(2, vis.implicated_color());
-  item->setHoverColor(vis.hover_color());
+  setColors(vis.inactive_color(), vis);
 
   // create line
   arrow_ = new QGraphicsLineItem;
@@ -31,11 +29,7 @@ FeedingArrow::FeedingArrow(Level level, ParentPosition parentpos,
   item->addToGroup(arrow_);
 
   // create arrow head
-  QPolygonF arrowpol;
-  arrowpol << QPointF(0.0, 0.0);
-  arrowpol << QPointF((parentpos == RightParent ? 1.0 : -1.0) * vis.feedingArrowHeadLength, 0.5*vis.feedingArrowHeadWidth);
-  arrowpol << QPointF((parentpos == RightParent ? 1.0 : -1.0) * vis.feedingArrowHeadLength, -0.5*vis.feedingArrowHeadWidth);
-  arrowhead_ = new QGraphicsPolygonItem(arrowpol);
+  arrowhead_ = new QGraphicsPolygonItem(arrowHead(parentpos, vis));
   arrowhead_->setBrush(QColor(arrow_->pen().color()));
   arrowhead_->setPen(Qt::NoPen);
   item->addToGroup(arrowhead_);
@@ -47,13 +41,13 @@ FeedingArrow::FeedingArrow(Level level, ParentPosition parentpos,
   intensity_->setFont(vis.feedIntensityFont());
   item->addToGroup(intensity_);
 
-  QFontMetrics stdBoldFontMetrics(vis.stdBoldFont());
+  int boldHeight = SchemeStyle::height(vis.stdBoldFont());
 
   click_area_
       = new QGraphicsRectItem(-vis.outerGammaMargin,
-                              -0.5*stdBoldFontMetrics.height(),
+                              -0.5*boldHeight,
                               2.0*vis.outerGammaMargin,
-                              stdBoldFontMetrics.height());
+                              boldHeight);
   click_area_->setPen(Qt::NoPen);
   click_area_->setBrush(Qt::NoBrush);
   item->addToGroup(click_area_);
@@ -76,7 +70,7 @@ void FeedingArrow::align(double arrowY,
                            double arrowleft,
                            double arrowright,
                            ParentPosition parentpos,
-                           SchemeVisualSettings vis)
+                           const SchemeVisualSettings& vis)
 {
   if (!arrow_)
     return;
@@ -87,7 +81,7 @@ void FeedingArrow::align(double arrowY,
   arrowhead_->setPos((parentpos == RightParent) ? rightlinelength + vis.feedingArrowGap : -leftlinelength - vis.feedingArrowGap, arrowY);
   intensity_->setPos(leftend + 15.0, arrowY - intensity_->boundingRect().height());
 
-  QFontMetrics stdBoldFontMetrics(vis.stdBoldFont());
+  int boldHeight = SchemeStyle::height(vis.stdBoldFont());
 
   item->removeFromGroup(click_area_);
   item->removeHighlightHelper(highlight_helper_);
@@ -96,9 +90,9 @@ void FeedingArrow::align(double arrowY,
                              rightend - leftend,
                              vis.highlightWidth);
   click_area_->setRect(leftend,
-                       arrowY - 0.5*stdBoldFontMetrics.height(),
+                       arrowY - 0.5*boldHeight,
                        rightend - leftend,
-                       stdBoldFontMetrics.height());
+                       boldHeight);
   item->addHighlightHelper(highlight_helper_);
   item->addToGroup(click_area_);
 }
@@ -108,6 +102,30 @@ Energy FeedingArrow::energy() const
   return energy_;
 }
 
+QPolygonF FeedingArrow::arrowHead(ParentPosition parentpos, const SchemeVisualSettings &vis)
+{
+  QPolygonF arrowpol;
+  arrowpol << QPointF(0.0, 0.0);
+  arrowpol << QPointF((parentpos == RightParent ? 1.0 : -1.0) * vis.feedingArrowHeadLength, 0.5*vis.feedingArrowHeadWidth);
+  arrowpol << QPointF((parentpos == RightParent ? 1.0 : -1.0) * vis.feedingArrowHeadLength, -0.5*vis.feedingArrowHeadWidth);
+  return arrowpol;
+}
+
+void FeedingArrow::restyle(const SchemeVisualSettings &vis)
+{
+  if (!arrow_)
+    return;
+
+  setColors(vis.inactive_color(), vis);
+  arrow_->setPen(vis.feedArrowPen);
+  arrowhead_->setPolygon(arrowHead(parentpos_, vis));
+  arrowhead_->setBrush(QColor(arrow_->pen().color()));
+
+  item->removeFromGroup(intensity_);
+  intensity_->setFont(vis.feedIntensityFont());
+  item->addToGroup(intensity_);
+}
+
 double FeedingArrow::intensity_width() const
 {
   if (intensity_)
@@ -154,9 +172,8 @@ double LevelItem::nuc_line_width() const
 
 void LevelItem::set_funky_position(double left, double right,
                                    double y,
-                                   SchemeVisualSettings vis)
+                                   const SchemeVisualSettings& vis)
 {
-  QFontMetrics stdBoldFontMetrics(vis.stdBoldFont());
   item->removeFromGroup(click_area_);
   item->removeFromGroup(line_);
   item->removeHighlightHelper(highlight_helper_);
@@ -166,9 +183,9 @@ void LevelItem::set_funky_position(double left, double right,
                              right - left,
                              vis.highlightWidth);
   click_area_->setRect(left,
-                       y - 0.5*stdBoldFontMetrics.height(),
+                       y - 0.5*bold_height_,
                        right - left,
-                       stdBoldFontMetrics.height());
+                       bold_height_);
   item->addHighlightHelper(highlight_helper_);
   item->addToGroup(line_);
   item->addToGroup(click_area_);
@@ -202,7 +219,7 @@ double LevelItem::above_ypos(double offset)
 }
 
 LevelItem::LevelItem(Level level, Type type, ParentPosition parentpos,
-                     SchemeVisualSettings vis,
+                     const SchemeVisualSettings& vis,
                      QGraphicsScene *scene)
   : LevelItem()
 {
@@ -212,25 +229,21 @@ LevelItem::LevelItem(Level level, Type type, ParentPosition parentpos,
   t = type;
   energy_ = level.energy();
 
-  QFontMetrics stdBoldFontMetrics(vis.stdBoldFont());
+  int boldHeight = SchemeStyle::height(vis.stdBoldFont());
 
   item = new ActiveGraphicsItemGroup(this);
-  item->setActiveColor(0, vis.inactive_color());
-  item->setActiveColor(1, vis.selected_color());
-  item->setActiveColor(2, vis.implicated_color());
-  item->setHoverColor(vis.hover_color());
+  setColors(vis.inactive_color(), vis);
 
   line_ = new QGraphicsLineItem(-vis.outerGammaMargin, 0.0, vis.outerGammaMargin, 0.0, item);
-  line_->setPen(vis.levelPen);
   // thick line for stable/isomeric levels
-  if (level.halfLife().stable() || level.isomerNum() > 0)
-    line_->setPen(vis.stableLevelPen);
+  thick_ = level.halfLife().stable() || level.isomerNum() > 0;
+  line_->setPen(thick_ ? vis.stableLevelPen : vis.levelPen);
 
   click_area_
       = new QGraphicsRectItem(-vis.outerGammaMargin,
-                              -0.5*stdBoldFontMetrics.height(),
+                              -0.5*boldHeight,
                               2.0*vis.outerGammaMargin,
-                              stdBoldFontMetrics.height());
+                              boldHeight);
   click_area_->setPen(Qt::NoPen);
   click_area_->setBrush(Qt::NoBrush);
 
@@ -244,12 +257,12 @@ LevelItem::LevelItem(Level level, Type type, ParentPosition parentpos,
   QString etext = QString::fromStdString(energy_.to_string());
   etext_ = new QGraphicsSimpleTextItem(etext, item);
   etext_->setFont(vis.stdBoldFont());
-  etext_->setPos(0.0, -stdBoldFontMetrics.height());
+  etext_->setPos(0.0, -boldHeight);
 
   QString spintext = QString::fromStdString(level.spins().to_pretty_string());
   spintext_ = new QGraphicsSimpleTextItem(spintext, item);
   spintext_->setFont(vis.stdBoldFont());
-  spintext_->setPos(0.0, -stdBoldFontMetrics.height());
+  spintext_->setPos(0.0, -boldHeight);
 
   if (parentpos != NoParent)
   {
@@ -257,9 +270,10 @@ LevelItem::LevelItem(Level level, Type type, ParentPosition parentpos,
         = QString::fromStdString(level.halfLife().preferred_units().to_string());
     hltext_ = new QGraphicsSimpleTextItem(hltext, item);
     hltext_->setFont(vis.stdFont());
-    hltext_->setPos(0.0, -0.5*stdBoldFontMetrics.height());
+    hltext_->setPos(0.0, -0.5*boldHeight);
     item->addToGroup(hltext_);
   }
+  measure(vis);
 
   item->addHighlightHelper(highlight_helper_);
   item->addToGroup(line_);
@@ -269,18 +283,25 @@ LevelItem::LevelItem(Level level, Type type, ParentPosition parentpos,
   scene->addItem(item);
 }
 
-void LevelItem::align(double leftlinelength, double rightlinelength,
-                      ParentPosition parentpos, SchemeVisualSettings vis)
+void LevelItem::measure(const SchemeVisualSettings &vis)
 {
-  QFontMetrics stdFontMetrics(vis.stdFont());
-  QFontMetrics stdBoldFontMetrics(vis.stdBoldFont());
+  bold_height_ = SchemeStyle::height(vis.stdBoldFont());
+  etext_advance_ = SchemeStyle::width(vis.stdBoldFont(), etext_->text());
+  if (hltext_)
+    hltext_advance_ = SchemeStyle::width(vis.stdFont(), hltext_->text());
+}
 
+void LevelItem::align(double leftlinelength, double rightlinelength,
+                      ParentPosition parentpos, const SchemeVisualSettings& vis)
+{
+  // children are placed in group coordinates, which only holds at the origin
+  item->setPos(0.0, 0.0);
   set_funky_position(-leftlinelength, rightlinelength, 0, vis);
 
   item->removeFromGroup(spintext_);
   item->removeFromGroup(etext_);
-  spintext_->setPos(-leftlinelength + vis.outerLevelTextMargin, -stdBoldFontMetrics.height());
-  etext_->setPos(rightlinelength - vis.outerLevelTextMargin - stdBoldFontMetrics.horizontalAdvance(etext_->text()), -etext_->boundingRect().height());
+  spintext_->setPos(-leftlinelength + vis.outerLevelTextMargin, -bold_height_);
+  etext_->setPos(rightlinelength - vis.outerLevelTextMargin - etext_advance_, -etext_->boundingRect().height());
   item->addToGroup(etext_);
   item->addToGroup(spintext_);
 
@@ -290,13 +311,40 @@ void LevelItem::align(double leftlinelength, double rightlinelength,
   if (parentpos == RightParent && hltext_)
     levelHlPos = -leftlinelength
         - vis.levelToHalfLifeDistance
-        - stdFontMetrics.horizontalAdvance(hltext_->text());
+        - hltext_advance_;
   else
     levelHlPos = rightlinelength + vis.levelToHalfLifeDistance;
   if (parentpos != NoParent)
-    hltext_->setPos(levelHlPos, -0.5*stdBoldFontMetrics.height());
+    hltext_->setPos(levelHlPos, -0.5*bold_height_);
   item->addToGroup(hltext_);
 
   item->setPos(0.0, ypos_);
 }
 
+
+void LevelItem::restyle(const SchemeVisualSettings &vis)
+{
+  if (!item)
+    return;
+
+  // children leave the group in scene coordinates, so restyle at the origin;
+  // the next alignment moves the group back into place
+  item->setPos(0.0, 0.0);
+  setColors(vis.inactive_color(), vis);
+  line_->setPen(thick_ ? vis.stableLevelPen : vis.levelPen);
+
+  item->removeFromGroup(etext_);
+  item->removeFromGroup(spintext_);
+  etext_->setFont(vis.stdBoldFont());
+  spintext_->setFont(vis.stdBoldFont());
+  item->addToGroup(etext_);
+  item->addToGroup(spintext_);
+
+  if (hltext_)
+  {
+    item->removeFromGroup(hltext_);
+    hltext_->setFont(vis.stdFont());
+    item->addToGroup(hltext_);
+  }
+  measure(vis);
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QPolygonF>
 #include "ClickableItem.h"
 #include "SchemeVisualSettings.h"
 #include <NucData/Level.h>
@@ -19,18 +20,21 @@ class FeedingArrow : public ClickableItem
   public:
     FeedingArrow() {}
     FeedingArrow(Level level, ParentPosition parentpos,
-                 SchemeVisualSettings vis,
+                 const SchemeVisualSettings& vis,
                  QGraphicsScene *scene);
 
     void align(double arrowY,
                  double leftlinelength, double rightlinelength,
                  double arrowleft, double arrowright,
-                 ParentPosition parentpos, SchemeVisualSettings vis);
+                 ParentPosition parentpos, const SchemeVisualSettings& vis);
 
     Energy energy() const;
 
     double intensity_width() const;
 
+    // applies pens, colors and fonts of a new style to the existing items
+    void restyle(const SchemeVisualSettings &vis);
+
   private:
     QGraphicsLineItem *arrow_ {nullptr};
     QGraphicsPolygonItem *arrowhead_ {nullptr};
@@ -40,6 +44,9 @@ class FeedingArrow : public ClickableItem
     GraphicsHighlightItem *highlight_helper_ {nullptr};
 
     Energy energy_;
+    ParentPosition parentpos_ {NoParent};
+
+    static QPolygonF arrowHead(ParentPosition parentpos, const SchemeVisualSettings &vis);
 };
 
 class LevelItem : public ClickableItem
@@ -47,12 +54,12 @@ class LevelItem : public ClickableItem
 public:
   LevelItem() {}
   LevelItem(Level level, Type type, ParentPosition parentpos,
-            SchemeVisualSettings vis,
+            const SchemeVisualSettings& vis,
             QGraphicsScene *scene);
 
   //returns feeding arrow height, if any
   void align(double leftlinelength, double rightlinelength,
-               ParentPosition parentpos, SchemeVisualSettings vis);
+               ParentPosition parentpos, const SchemeVisualSettings& vis);
 
   Energy energy() const;
 
@@ -65,11 +72,14 @@ public:
   double bottom_ypos() const;
   double nuc_line_width() const;
 
-  void set_funky_position(double left, double right, double y, SchemeVisualSettings vis);
+  void set_funky_position(double left, double right, double y, const SchemeVisualSettings& vis);
   void set_funky2_position(double xe, double xspin, double y);
 
   double max_y_height() const;
 
+  // applies pens, colors and fonts of a new style to the existing items
+  void restyle(const SchemeVisualSettings &vis);
+
 private:
   Energy energy_;
 
@@ -80,4 +90,11 @@ private:
   QGraphicsRectItem *click_area_ {nullptr};
   GraphicsHighlightItem *highlight_helper_ {nullptr};
   double ypos_ {0.0};
+  bool thick_ {false};
+
+  // label metrics, measured once per font
+  double etext_advance_ {0.0};
+  double hltext_advance_ {0.0};
+  double bold_height_ {0.0};
+  void measure(const SchemeVisualSettings &vis);
 };
@@ -2,7 +2,7 @@
 #include <QGraphicsScene>
 #include "ActiveGraphicsItemGroup.h"
 #include <QGraphicsSimpleTextItem>
-#include <QFontMetrics>
+#include "SchemeStyle.h"
 #include <QBrush>
 #include <boost/algorithm/string.hpp>
 #include "GraphicsHighlightItem.h"
@@ -29,7 +29,7 @@ void NuclideItem::position_text(double parent_center_x,
 
 
 NuclideItem::NuclideItem(const Nuclide &nuc, Type tp,
-                         SchemeVisualSettings vis,
+                         const SchemeVisualSettings& vis,
                          QGraphicsScene *scene)
   : ClickableItem(tp)
 {
@@ -44,61 +44,27 @@ NuclideItem::NuclideItem(const Nuclide &nuc, Type tp,
 
   id_ = nuc.id();
   item = new ActiveGraphicsItemGroup(this);
-  item->setActiveColor(0, vis.nuclide_color());
-  item->setActiveColor(1, vis.selected_color());
-  item->setActiveColor(2, vis.implicated_color());
-  item->setHoverColor(vis.hover_color());
+  setColors(vis.nuclide_color(), vis);
   scene->addItem(item);
 
-  double numberToNameDistance = 4.0;
-
-  QFontMetrics nucFontMetrics(vis.nucFont());
-  QFontMetrics nucIndexFontMetrics(vis.nucIndexFont());
-
-  auto symbol = new QGraphicsSimpleTextItem(QString::fromStdString(nuc.id().element()), item);
-  symbol->setFont(vis.nucFont());
-  symbol->setBrush(QBrush(vis.nuclide_color()));
-  item->addToGroup(symbol);
-
-  auto A_text = new QGraphicsSimpleTextItem(QString::number(nuc.id().A()), item);
-  A_text->setFont(vis.nucIndexFont());
-  A_text->setBrush(QBrush(vis.nuclide_color()));
-  item->addToGroup(A_text);
-
-  auto Z_text = new QGraphicsSimpleTextItem(QString::number(nuc.id().Z()), item);
-  Z_text->setFont(vis.nucIndexFont());
-  Z_text->setBrush(QBrush(vis.nuclide_color()));
-  item->addToGroup(Z_text);
-
-  double numberwidth
-      = qMax(A_text->boundingRect().width(),
-             Z_text->boundingRect().width());
-
-  symbol->setPos(numberwidth + numberToNameDistance,
-                 0.2*nucIndexFontMetrics.ascent());
-  A_text->setPos(numberwidth - A_text->boundingRect().width(), 0.0);
-  Z_text->setPos(numberwidth - Z_text->boundingRect().width(), 1.2*nucIndexFontMetrics.ascent());
-
-  highlight_helper_
-      = new GraphicsHighlightItem(numberwidth - A_text->boundingRect().width(),
-                                  0.2*nucIndexFontMetrics.ascent(),
-                                  numberwidth + numberToNameDistance + symbol->boundingRect().width(),
-                                  nucFontMetrics.height());
-  highlight_helper_->setOpacity(0.0);
-  item->addHighlightHelper(highlight_helper_);
-
-
-  click_area_
-      = new QGraphicsRectItem(numberwidth - A_text->boundingRect().width(),
-                              0.2*nucIndexFontMetrics.ascent(),
-                              numberwidth + numberToNameDistance + symbol->boundingRect().width(),
-                              nucFontMetrics.height());
+  symbol_ = new QGraphicsSimpleTextItem(QString::fromStdString(nuc.id().element()));
+  A_text_ = new QGraphicsSimpleTextItem(QString::number(nuc.id().A()));
+  Z_text_ = new QGraphicsSimpleTextItem(QString::number(nuc.id().Z()));
+  click_area_ = new QGraphicsRectItem;
   click_area_->setPen(Qt::NoPen);
   click_area_->setBrush(Qt::NoBrush);
-  item->addToGroup(click_area_);
+  highlight_helper_ = new GraphicsHighlightItem(0.0, 0.0, 0.0, 0.0);
+  highlight_helper_->setOpacity(0.0);
+
+  layoutLabel(vis);
 
   // added in the end to work around a bug in QGraphicsItemGroup:
   //   it does not update boundingRect if contents are moved after adding them
+  item->addToGroup(symbol_);
+  item->addToGroup(A_text_);
+  item->addToGroup(Z_text_);
+  item->addHighlightHelper(highlight_helper_);
+  item->addToGroup(click_area_);
 
   if (tp == ParentNuclideType)
   {
@@ -113,3 +79,63 @@ NuclideItem::NuclideItem(const Nuclide &nuc, Type tp,
     scene->addItem(vertical_arrow_);
   }
 }
+
+void NuclideItem::layoutLabel(const SchemeVisualSettings &vis)
+{
+  double numberToNameDistance = 4.0;
+
+  int nucHeight = SchemeStyle::height(vis.nucFont());
+  int nucIndexAscent = SchemeStyle::ascent(vis.nucIndexFont());
+
+  symbol_->setFont(vis.nucFont());
+  symbol_->setBrush(QBrush(vis.nuclide_color()));
+  A_text_->setFont(vis.nucIndexFont());
+  A_text_->setBrush(QBrush(vis.nuclide_color()));
+  Z_text_->setFont(vis.nucIndexFont());
+  Z_text_->setBrush(QBrush(vis.nuclide_color()));
+
+  double numberwidth
+      = qMax(A_text_->boundingRect().width(),
+             Z_text_->boundingRect().width());
+
+  symbol_->setPos(numberwidth + numberToNameDistance,
+                  0.2*nucIndexAscent);
+  A_text_->setPos(numberwidth - A_text_->boundingRect().width(), 0.0);
+  Z_text_->setPos(numberwidth - Z_text_->boundingRect().width(), 1.2*nucIndexAscent);
+
+  QRectF label(numberwidth - A_text_->boundingRect().width(),
+               0.2*nucIndexAscent,
+               numberwidth + numberToNameDistance + symbol_->boundingRect().width(),
+               nucHeight);
+  highlight_helper_->setRect(label);
+  click_area_->setRect(label);
+}
+
+void NuclideItem::restyle(const SchemeVisualSettings &vis)
+{
+  if (!item)
+    return;
+
+  // children leave the group in scene coordinates, so lay out at the origin;
+  // the next alignment moves the group back into place
+  item->setPos(0.0, 0.0);
+  item->removeFromGroup(symbol_);
+  item->removeFromGroup(A_text_);
+  item->removeFromGroup(Z_text_);
+  item->removeFromGroup(click_area_);
+  item->removeHighlightHelper(highlight_helper_);
+
+  layoutLabel(vis);
+
+  item->addToGroup(symbol_);
+  item->addToGroup(A_text_);
+  item->addToGroup(Z_text_);
+  item->addHighlightHelper(highlight_helper_);
+  item->addToGroup(click_area_);
+  setColors(vis.nuclide_color(), vis);
+
+  if (halflife_text_)
+    halflife_text_->setFont(vis.parentHlFont());
+  if (vertical_arrow_)
+    vertical_arrow_->setPen(vis.feedArrowPen);
+}
@@ -21,18 +21,26 @@ class NuclideItem : public ClickableItem
 public:
   NuclideItem();
   NuclideItem(const Nuclide& nuc, Type tp,
-              SchemeVisualSettings vis,
+              const SchemeVisualSettings& vis,
               QGraphicsScene *scene);
 
   void position_arrow(double x, double start, double end);
   void position_text(double parent_center_x,
                      double ypos);
 
+  // applies colors and fonts of a new style to the existing items
+  void restyle(const SchemeVisualSettings &vis);
+
 private:
+  QGraphicsSimpleTextItem *symbol_ {nullptr};
+  QGraphicsSimpleTextItem *A_text_ {nullptr};
+  QGraphicsSimpleTextItem *Z_text_ {nullptr};
   GraphicsHighlightItem *highlight_helper_ {nullptr};
   QGraphicsSimpleTextItem *halflife_text_ {nullptr};
   QGraphicsLineItem *vertical_arrow_ {nullptr};
   QGraphicsRectItem *click_area_ {nullptr};
 
   NuclideId id_;
+
+  void layoutLabel(const SchemeVisualSettings &vis);
 };
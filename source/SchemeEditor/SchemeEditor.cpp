@@ -2,17 +2,17 @@
 #include "ui_SchemeEditor.h"
 
 #include "SchemeEditorPrefs.h"
+#include "SchemeRender.h"
+#include "SchemeStyle.h"
 
 #include <QSettings>
-#include <QSvgGenerator>
 #include <QFileDialog>
-#include <QPrinter>
-#include <boost/algorithm/string.hpp>
 #include "ScrollZoomView.h"
 
-#include <qpagelayout.h>
-#include <qpagesize.h>
 #include <util/logger.h>
+#include <util/trace.h>
+#include <cctype>
+#include <unordered_map>
 
 SchemeEditor::SchemeEditor(QWidget *parent)
   : QWidget(parent)
@@ -27,6 +27,7 @@ SchemeEditor::SchemeEditor(QWidget *parent)
   ui->decayView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
   Graphics_view_zoom* z = new Graphics_view_zoom(ui->decayView);
   z->set_modifiers(Qt::NoModifier);
+  connect(z, SIGNAL(zoomed()), this, SLOT(updateLevelOfDetail()));
 
   ui->textBrowser->setOpenLinks(true);
   ui->textBrowser->setOpenExternalLinks(true);
@@ -51,6 +52,13 @@ void SchemeEditor::on_pushShowAll_clicked()
   QGraphicsScene *scene = ui->decayView->scene();
   if (scene)
     ui->decayView->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);
+  updateLevelOfDetail();
+}
+
+void SchemeEditor::updateLevelOfDetail()
+{
+  if (decay_viewer_)
+    decay_viewer_->setViewScale(ui->decayView->transform().m11());
 }
 
 void SchemeEditor::on_pushExportSvg_clicked()
@@ -65,20 +73,10 @@ void SchemeEditor::on_pushExportSvg_clicked()
   if (fn.isEmpty())
     return;
 
-  QRectF inrect = ui->decayView->scene()->sceneRect();
-  QRectF outrect = inrect.adjusted(-10.0, -10.0, 10.0, 10.0);
-
-  QSvgGenerator svgGen;
-  svgGen.setFileName(fn);
-  svgGen.setSize(outrect.toRect().size());
-  svgGen.setViewBox(outrect);
-  svgGen.setTitle("Decay Level Scheme for the decay " + decay_viewer_->name());
-  svgGen.setDescription(QString::fromUtf8("This scheme was created using SchemeEditor"));
-
-  decay_viewer_->setShadowEnabled(false);
-  QPainter painter(&svgGen);
-  ui->decayView->scene()->render(&painter, inrect, inrect);
+  if (!render_svg(*decay_viewer_, fn))
+    ERR("<SchemeEditor> Could not write {}", fn.toStdString());
   decay_viewer_->setShadowEnabled(true);
+  updateLevelOfDetail();
 }
 
 void SchemeEditor::on_pushExportPdf_clicked()
@@ -93,43 +91,35 @@ void SchemeEditor::on_pushExportPdf_clicked()
   if (fn.isEmpty())
     return;
 
-  const int scalefactor = 10;
-  const double margin = 3.0;
-
-  QRectF inrect = ui->decayView->scene()->sceneRect();
-  QRectF outrect = inrect.adjusted(-margin*scalefactor, -margin*scalefactor, margin*scalefactor, margin*scalefactor);
-
-  QPrinter p(QPrinter::HighResolution);
-  p.setOutputFileName(fn);
-  p.setPageMargins(QMarginsF(margin, margin, margin, margin), QPageLayout::Millimeter);
-  p.setOutputFormat(QPrinter::PdfFormat);
-  p.setPageSize(QPageSize(QSizeF(outrect.width() / scalefactor, outrect.height() / scalefactor), QPageSize::Millimeter));
-  p.setDocName("Decay Level Scheme for the decay " + decay_viewer_->name());
-  p.setCreator(QString("%1 %2 (%3)").arg(QCoreApplication::applicationName(), QCoreApplication::applicationVersion(), "SchemeEditorURL"));
-
-  decay_viewer_->setShadowEnabled(false);
-  QPainter painter(&p);
-  ui->decayView->scene()->render(&painter);
+  if (!render_pdf(*decay_viewer_, fn))
+    ERR("<SchemeEditor> Could not write {}", fn.toStdString());
   decay_viewer_->setShadowEnabled(true);
+  updateLevelOfDetail();
 }
 
 void SchemeEditor::loadDecay(DecayScheme decay)
 {
   current_scheme_ = decay;
+  text_cache_.clear();
+  reference_keys_.clear();
+  for (const auto& r : current_scheme_.references())
+    reference_keys_.insert(r);
   refresh_scheme();
 }
 
 void SchemeEditor::refresh_scheme()
 {
-  QSettings s;
-  auto prefs = SchemeVisualSettings::load(s);
+  TRACE_SCOPE("SchemeEditor::refresh_scheme");
 
+  // the scene belongs to the viewer and goes with it
+  if (decay_viewer_)
+    decay_viewer_->deleteLater();
   decay_viewer_ = new SchemeGraphics(current_scheme_,
                                    ui->doubleMinIntensity->value(), this);
 
   connect(decay_viewer_.data(), SIGNAL(selectionChanged()),
           this, SLOT(playerSelectionChanged()));
-  decay_viewer_->setStyle(prefs);
+  decay_viewer_->setStyle(SchemeStyle::settings());
   decay_viewer_->set_highlight_cascade(ui->checkFilterTransitions->isChecked());
   QGraphicsScene *scene = decay_viewer_->levelPlot();
   ui->decayView->setScene(scene);
@@ -146,82 +136,138 @@ void SchemeEditor::playerSelectionChanged()
   if (!decay_viewer_)
     return;
 
-  json comments;
-  if (decay_viewer_->selected_levels(1).size())
+  auto levels_selected = decay_viewer_->selected_levels(1);
+  auto feedings_selected = decay_viewer_->selected_feedings(1);
+  auto parent_levels_selected = decay_viewer_->selected_parent_levels(1);
+  auto transitions_selected = decay_viewer_->selected_transistions(1);
+
+  TextKey key {SchemeText, Energy()};
+  if (levels_selected.size())
+    key = {LevelText, *levels_selected.begin()};
+  else if (feedings_selected.size())
+    key = {FeedingText, *feedings_selected.begin()};
+  else if (parent_levels_selected.size())
+    key = {ParentLevelText, *parent_levels_selected.begin()};
+  else if (transitions_selected.size())
+    key = {TransitionText, *transitions_selected.begin()};
+  else if (decay_viewer_->parent_selected())
+    key = {ParentText, Energy()};
+  else if (decay_viewer_->daughter_selected())
+    key = {DaughterText, Energy()};
+
+  auto cached = text_cache_.find(key);
+  if (cached == text_cache_.end())
+    cached = text_cache_.emplace(key, render_text(item_text(key))).first;
+  ui->textBrowser->setHtml(cached->second);
+}
+
+json SchemeEditor::item_text(const TextKey& key) const
+{
+  switch (key.first)
   {
-    auto nrg = *decay_viewer_->selected_levels(1).begin();
-    auto levels = current_scheme_.daughterNuclide().levels();
-    if (levels.count(nrg))
-      comments = levels[nrg].text();
-  }
-  else if (decay_viewer_->selected_feedings(1).size())
+  case LevelText:
   {
-    auto nrg = *decay_viewer_->selected_feedings(1).begin();
-    auto levels = current_scheme_.parentNuclide().levels();
-    if (levels.count(nrg))
-      comments = levels[nrg].text(); //should be something else
+    auto levels = current_scheme_.daughterNuclide().levels();
+    if (levels.count(key.second))
+      return levels[key.second].text();
+    return json();
   }
-  else if (decay_viewer_->selected_parent_levels(1).size())
+  case FeedingText:
+  case ParentLevelText:
   {
-    auto nrg = *decay_viewer_->selected_parent_levels(1).begin();
     auto levels = current_scheme_.parentNuclide().levels();
-    if (levels.count(nrg))
-      comments = levels[nrg].text();
+    if (levels.count(key.second))
+      return levels[key.second].text(); //should be something else for feedings
+    return json();
   }
-  else if (decay_viewer_->selected_transistions(1).size())
+  case TransitionText:
   {
-    auto nrg = *decay_viewer_->selected_transistions(1).begin();
     auto transitions = current_scheme_.daughterNuclide().transitions();
-    if (!transitions.count(nrg))
-      return;
-    comments = transitions[nrg].text();
+    if (transitions.count(key.second))
+      return transitions[key.second].text();
+    return json();
+  }
+  case ParentText:
+    return current_scheme_.parentNuclide().text();
+  case DaughterText:
+    return current_scheme_.daughterNuclide().text();
+  default:
+    return current_scheme_.text();
   }
-  else if (decay_viewer_->parent_selected())
-    comments = current_scheme_.parentNuclide().text();
-  else if (decay_viewer_->daughter_selected())
-    comments = current_scheme_.daughterNuclide().text();
-  else
-    comments = current_scheme_.text();
-
-  set_text(comments);
 }
 
-void SchemeEditor::set_text(const json& jj)
+QString SchemeEditor::render_text(const json& jj) const
 {
-  auto refs = current_scheme_.references();
   QString text;
   for (const auto& j : jj)
   {
     text += "<h3>" + QString::fromStdString(j["heading"]) + "</h3>";
     for (const auto& p : j["pars"])
-      text += prep_comments(p, refs) + "<br>";
+      text += QString::fromStdString(prep_comments(p)) + "<br>";
   }
-  ui->textBrowser->setHtml(text);
+  return text;
 }
 
-QString SchemeEditor::prep_comments(const json& j,
-                              const std::set<std::string>& refs)
+namespace
 {
-  QString text;
 
-  int refnum = 1;
-  for (auto c : j)
+// reference keys have the fixed shape of RGX_KEYNUM, e.g. 1990AbCd:
+// four digits, then four word characters
+constexpr size_t keynum_size = 8;
+
+bool is_word(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+}
+
+bool keynum_at(const std::string& text, size_t i)
+{
+  if (i + keynum_size > text.size())
+    return false;
+  for (size_t k = 0; k < 4; ++k)
+    if (!std::isdigit(static_cast<unsigned char>(text[i + k])))
+      return false;
+  for (size_t k = 4; k < keynum_size; ++k)
+    if (!is_word(text[i + k]))
+      return false;
+  return true;
+}
+
+}
+
+std::string SchemeEditor::prep_comments(const json& j) const
+{
+  std::string ret;
+
+  // links are numbered per paragraph, in order of first mention
+  std::unordered_map<std::string, int> numbers;
+  for (const auto& c : j)
   {
-    auto newtext = c.get<std::string>();
-    for (const auto& r : refs)
-      if (boost::contains(newtext, r))
+    const auto& text = c.get_ref<const std::string&>();
+    ret.reserve(ret.size() + text.size());
+    size_t i = 0;
+    while (i < text.size())
+    {
+      if (keynum_at(text, i))
       {
-        boost::replace_all(newtext, r,
-                           make_reference_link(r, refnum++));
+        std::string key = text.substr(i, keynum_size);
+        if (reference_keys_.count(key))
+        {
+          int num = numbers.emplace(key, int(numbers.size()) + 1).first->second;
+          ret += make_reference_link(key, num);
+          i += keynum_size;
+          continue;
+        }
       }
-    text += QString::fromStdString(newtext);
+      ret += text[i++];
+    }
   }
 
-  return text;
+  return ret;
 }
 
 
-std::string SchemeEditor::make_reference_link(std::string ref, int num)
+std::string SchemeEditor::make_reference_link(const std::string& ref, int num)
 {
   return "<a href=\"https://www.nndc.bnl.gov/nsr/knum_act.jsp?ofrml=Normal&keylst="
       + ref + "%0D%0A&getkl=Search\"><small>"
@@ -248,18 +294,24 @@ void SchemeEditor::on_doubleTargetTransition_editingFinished()
 
 void SchemeEditor::on_doubleMinIntensity_editingFinished()
 {
-  refresh_scheme();
+  if (!decay_viewer_)
+    return;
+  decay_viewer_->setMinIntensity(ui->doubleMinIntensity->value());
+  QGraphicsScene *scene = decay_viewer_->levelPlot();
+  ui->decayView->setSceneRect(scene->sceneRect().adjusted(-20, -20, 20, 20));
 }
 
 void SchemeEditor::on_pushPrefs_clicked()
 {
-  QSettings s;
-  auto prefs = SchemeVisualSettings::load(s);
-
-  auto prefsDalog = new SchemeEditorPrefs(prefs, this);
+  auto prefsDalog = new SchemeEditorPrefs(SchemeStyle::settings(), this);
   if (prefsDalog->exec() == QDialog::Accepted)
   {
-    prefsDalog->prefs().save(s);
-    refresh_scheme();
+    SchemeStyle::setSettings(prefsDalog->prefs());
+    if (!decay_viewer_)
+      return;
+    decay_viewer_->setStyle(SchemeStyle::settings());
+    QGraphicsScene *scene = decay_viewer_->levelPlot();
+    ui->decayView->setSceneRect(scene->sceneRect().adjusted(-20, -20, 20, 20));
+    updateLevelOfDetail();
   }
 }
@@ -3,6 +3,7 @@
 #include <QWidget>
 #include <QPointer>
 #include "SchemeGraphics.h"
+#include <unordered_set>
 
 namespace Ui
 {
@@ -24,6 +25,7 @@ private slots:
   void on_checkFilterTransitions_clicked();
   void on_doubleTargetTransition_editingFinished();
   void on_doubleMinIntensity_editingFinished();
+  void updateLevelOfDetail();
 
   void on_pushShowAll_clicked();
   void on_pushExportSvg_clicked();
@@ -37,10 +39,18 @@ private:
   QPointer<SchemeGraphics> decay_viewer_;
   DecayScheme current_scheme_;
 
-  std::string make_reference_link(std::string ref, int num);
-  QString prep_comments(const json& j,
-                        const std::set<std::string>& refs);
-  void set_text(const json& jj);
+  // the text pane shows one item, rendered html is kept per item
+  // until another scheme is loaded
+  enum TextSource { SchemeText, LevelText, FeedingText, ParentLevelText,
+                    TransitionText, ParentText, DaughterText };
+  using TextKey = std::pair<TextSource, Energy>;
+  std::map<TextKey, QString> text_cache_;
+  std::unordered_set<std::string> reference_keys_;
+
+  json item_text(const TextKey& key) const;
+  QString render_text(const json& jj) const;
+  std::string prep_comments(const json& j) const;
+  static std::string make_reference_link(const std::string& ref, int num);
 
   void refresh_scheme();
 };
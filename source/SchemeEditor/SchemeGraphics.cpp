@@ -6,20 +6,26 @@
 #include <QGraphicsRectItem>
 #include <QGraphicsDropShadowEffect>
 #include <QTextDocument>
-#include <QFontMetrics>
 #include <QVector>
 #include <cmath>
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <vector>
 #include "ActiveGraphicsItemGroup.h"
+#include "ColumnPacker.h"
 #include "GraphicsHighlightItem.h"
+#include "SchemeStyle.h"
 
 #include <util/logger.h>
+#include <util/trace.h>
 
 #include "LevelItem.h"
 #include "TransitionItem.h"
 
+#include <NucData/CascadeClosure.h>
+
 SchemeGraphics::SchemeGraphics(DecayScheme scheme, double min_intensity, QObject *parent)
   : QObject(parent)
   , scheme_(scheme)
@@ -58,6 +64,8 @@ GraphicsScene *SchemeGraphics::levelPlot()
   if (scene_)
     return scene_;
 
+  TRACE_SCOPE("SchemeGraphics::levelPlot");
+
   scene_ = new GraphicsScene(this);
   connect(scene_, SIGNAL(clickedBackground()), this,
           SLOT(backgroundClicked()));
@@ -105,6 +113,10 @@ void SchemeGraphics::addDaughter(Nuclide nuc)
   connectItem(daughter_);
 
   auto transitions = nuc.transitions();
+  for (const auto& t : transitions)
+    transition_index_.emplace(t.first, transition_index_.size());
+  transition_items_.assign(transitions.size(), nullptr);
+
   auto levels = nuc.levels();
   for (const auto& level : levels)
   {
@@ -112,7 +124,8 @@ void SchemeGraphics::addDaughter(Nuclide nuc)
     auto depoptrans = level.second.depopulatingTransitions();
 
     for (const auto& it : depoptrans)
-      addTransition(transitions.at(it));
+      if (auto item = addTransition(transitions.at(it)))
+        transition_items_[transition_index_.at(it)] = item;
   }
 }
 
@@ -131,20 +144,30 @@ void SchemeGraphics::addLevel(Level level)
   }
 }
 
-void SchemeGraphics::addTransition(Transition transition)
+TransitionItem* SchemeGraphics::addTransition(Transition transition)
 {
-  if (transition.intensity().value() < min_intensity_ || (!transition.energy().valid()))
-    return;
+  if (!transition.energy().valid())
+    return nullptr;
+  // weak transitions are kept hidden, so the threshold can change later
   TransitionItem *transrend
       = new TransitionItem(transition, visual_settings_, scene_);
+  transrend->graphicsItem()->setVisible(passes(transrend));
   connectItem(transrend);
   transitions_.push_back(transrend);
+  return transrend;
+}
+
+bool SchemeGraphics::passes(const TransitionItem* transition) const
+{
+  return !(transition->transition().intensity().value() < min_intensity_);
 }
 
 void SchemeGraphics::connectItem(ClickableItem* item)
 {
   connect(this, SIGNAL(enabledShadow(bool)),
           item->graphicsItem(), SLOT(setShadowEnabled(bool)));
+  connect(this, SIGNAL(detailChanged(bool)),
+          item->graphicsItem(), SLOT(setDetailed(bool)));
   connect(item->graphicsItem(), SIGNAL(clicked(ClickableItem*)),
           this, SLOT(itemClicked(ClickableItem*)));
 }
@@ -154,23 +177,15 @@ void SchemeGraphics::alignGraphicsItems()
   if (!scheme_.valid())
     return;
 
-  QFontMetrics stdFontMetrics(visual_settings_.stdFont());
-  QFontMetrics stdBoldFontMetrics(visual_settings_.stdBoldFont());
-  QFontMetrics parentHlFontMetrics(visual_settings_.parentHlFont());
-  //  QFontMetrics feedIntensityFontMetrics(feedIntensityFont);
+  TRACE_SCOPE("SchemeGraphics::alignGraphicsItems");
 
-  // determine size information
-  int maxEnergyLabelWidth {0};
-  int maxSpinLabelWidth {0};
-
-  for (auto level : daughter_levels_)
-  {
-    maxSpinLabelWidth
-        = qMax(maxSpinLabelWidth, level.second->spin_width());
-    maxEnergyLabelWidth
-        = qMax(maxEnergyLabelWidth, level.second->energy_width());
-  }
+  alignLevels();
+  alignTransitions(true);
+  alignLines();
+}
 
+void SchemeGraphics::alignLevels()
+{
   // determine y coordinates for all levels
   if (!daughter_levels_.empty())
   {
@@ -200,44 +215,88 @@ void SchemeGraphics::alignGraphicsItems()
       prev_level = i.second;
     }
   }
+}
 
-  // determine space needed for gammas
-  double gammaspace {0};
+void SchemeGraphics::alignTransitions(bool arrows)
+{
   double max_intensity {0};
   for (auto &gamma : transitions_)
+    if (gamma->graphicsItem()->isVisible())
+      max_intensity = qMax(max_intensity, gamma->intensity());
+
+  // arrows only depend on the level heights
+  if (arrows)
+    for (auto &gamma : transitions_)
+      if (daughter_levels_.count(gamma->from())
+          && daughter_levels_.count(gamma->to()))
+      {
+        double arrowDestY =
+            daughter_levels_.at(gamma->to())->ypos()
+            - daughter_levels_.at(gamma->from())->ypos();
+        gamma->graphicsItem()->setPos(0.0, 0.0);
+        gamma->updateArrow(arrowDestY, max_intensity);
+      }
+
+  // measure vertical extents, upwards from the bottom of the scheme
+  std::vector<TransitionItem*> placed;
+  std::vector<ColumnFootprint> footprints;
+  double pitch {0};
+  for (auto &gamma : transitions_)
+  {
+    if (!gamma->graphicsItem()->isVisible()
+        || !daughter_levels_.count(gamma->from()))
+      continue;
+    ColumnFootprint f;
+    f.base = -daughter_levels_.at(gamma->from())->bottom_ypos();
+    f.low = daughter_levels_.count(gamma->to())
+        ? -daughter_levels_.at(gamma->to())->ypos() : f.base;
+    f.high = f.base + gamma->heightAboveOrigin();
+    placed.push_back(gamma);
+    footprints.push_back(f);
+    pitch = qMax(pitch, gamma->minimalXDistance());
+  }
+
+  std::vector<int> columns = packColumns(footprints, pitch,
+                                         pitch * TransitionItem::labelSlope());
+
+  // leave room on the right for labels reaching past the first column
+  int count {0};
+  double room {0};
+  for (size_t i = 0; i < placed.size(); ++i)
   {
-    if (!gammaspace)
-      gammaspace = gamma->widthFromOrigin();
-    gammaspace += gamma->minimalXDistance();
-    max_intensity = qMax(max_intensity, gamma->intensity());
+    count = qMax(count, columns[i] + 1);
+    room = qMax(room, placed[i]->widthFromOrigin() - columns[i] * pitch);
   }
+  gammaspace_ = count ? room + count * pitch : 0.0;
 
-  // set gamma positions
-  double currentgammapos = 0.5*gammaspace;
-  bool firstgamma = true;
+  // hidden ones wait in the middle
   for (auto &gamma : transitions_)
+    if (!gamma->graphicsItem()->isVisible()
+        && daughter_levels_.count(gamma->from()))
+      gamma->graphicsItem()->setPos(
+            0.0, daughter_levels_.at(gamma->from())->bottom_ypos());
+
+  for (size_t i = 0; i < placed.size(); ++i)
   {
-    if (firstgamma)
-    {
-      currentgammapos -= gamma->widthFromOrigin();
-      firstgamma = false;
-    }
-    else
-      currentgammapos -= gamma->minimalXDistance();
+    double x = 0.5*gammaspace_ - room - columns[i] * pitch;
+    placed[i]->graphicsItem()->setPos(
+          std::floor(x) + 0.5 * placed[i]->pen().widthF(),
+          daughter_levels_.at(placed[i]->from())->bottom_ypos());
+  }
+}
 
-    if (daughter_levels_.count(gamma->from())
-        && daughter_levels_.count(gamma->to()))
-    {
-      double arrowDestY =
-          daughter_levels_.at(gamma->to())->ypos()
-          - daughter_levels_.at(gamma->from())->ypos();
-      gamma->updateArrow(arrowDestY, max_intensity);
-    }
+void SchemeGraphics::alignLines()
+{
+  // determine size information
+  int maxEnergyLabelWidth {0};
+  int maxSpinLabelWidth {0};
 
-    if (daughter_levels_.count(gamma->from()))
-      gamma->graphicsItem()->setPos(
-            std::floor(currentgammapos) + 0.5 * gamma->pen().widthF(),
-            daughter_levels_.at(gamma->from())->bottom_ypos());
+  for (auto level : daughter_levels_)
+  {
+    maxSpinLabelWidth
+        = qMax(maxSpinLabelWidth, level.second->spin_width());
+    maxEnergyLabelWidth
+        = qMax(maxEnergyLabelWidth, level.second->energy_width());
   }
 
   // determine line length for parent levels
@@ -267,10 +326,10 @@ void SchemeGraphics::alignGraphicsItems()
   // calculate length of level lines
   double leftlinelength = visual_settings_.outerLevelTextMargin
       + maxSpinLabelWidth + visual_settings_.outerGammaMargin
-      + 0.5*gammaspace;
+      + 0.5*gammaspace_;
   double rightlinelength = visual_settings_.outerLevelTextMargin
       + maxEnergyLabelWidth + visual_settings_.outerGammaMargin
-      + 0.5*gammaspace;
+      + 0.5*gammaspace_;
 
   // calculate start and end points of parent level lines
   double arrowleft = std::floor((parentpos_ == RightParent) ? rightlinelength : -leftlinelength - arrowLineLength - visual_settings_.parentNuclideLevelLineExtraLength) - 0.5*visual_settings_.feedArrowPen.widthF();
@@ -346,8 +405,8 @@ void SchemeGraphics::alignGraphicsItems()
     parent_->position_arrow(arrowX, arrowVStart, arrowVEnd);
     parent_->position_text(parentcenter,
                            topMostLevel
-                           - stdBoldFontMetrics.height()
-                           - parentHlFontMetrics.height());
+                           - SchemeStyle::height(visual_settings_.stdBoldFont())
+                           - SchemeStyle::height(visual_settings_.parentHlFont()));
   }
 }
 
@@ -357,6 +416,22 @@ void SchemeGraphics::setShadowEnabled(bool enable)
   emit enabledShadow(enable);
 }
 
+void SchemeGraphics::setViewScale(double scale)
+{
+  // smallest label height, in pixels, still worth drawing
+  static const double min_label_pixels = 4.0;
+  setDetailed(SchemeStyle::height(visual_settings_.gammaFont()) * scale
+              >= min_label_pixels);
+}
+
+void SchemeGraphics::setDetailed(bool detailed)
+{
+  if (detailed == detailed_)
+    return;
+  detailed_ = detailed;
+  emit detailChanged(detailed);
+}
+
 QString SchemeGraphics::name() const
 {
   return QString::fromStdString(scheme_.name());
@@ -394,32 +469,63 @@ void SchemeGraphics::clearSelection()
   deselect_all();
 }
 
+template <typename Item>
+void SchemeGraphics::highlight(Item* item, Selection& selection, int level)
+{
+  int old = item->graphicsItem()->isHighlighted();
+  if (old == level)
+    return;
+  if (old)
+  {
+    auto it = selection.find(old);
+    it->second.erase(item->energy());
+    if (it->second.empty())
+      selection.erase(it);
+  }
+  if (level)
+    selection[level].insert(item->energy());
+  item->graphicsItem()->setHighlighted(level);
+}
+
+std::set<Energy> SchemeGraphics::selected(const Selection& selection, int level)
+{
+  auto it = selection.find(level);
+  if (it == selection.end())
+    return std::set<Energy>();
+  return it->second;
+}
+
 void SchemeGraphics::select_levels(const std::set<Energy>& s, int level)
 {
-  for (auto t : daughter_levels_)
-    if (s.count(t.first))
-      t.second->graphicsItem()->setHighlighted(level);
+  for (auto e : s)
+    if (daughter_levels_.count(e))
+      highlight(daughter_levels_.at(e), levels_selection_, level);
 }
 
 void SchemeGraphics::select_feedings(const std::set<Energy>& s, int level)
 {
-  for (auto t : feeding_arrows_)
-    if (s.count(t.first))
-      t.second->graphicsItem()->setHighlighted(level);
+  for (auto e : s)
+    if (feeding_arrows_.count(e))
+      highlight(feeding_arrows_.at(e), feedings_selection_, level);
 }
 
 void SchemeGraphics::select_parent_levels(const std::set<Energy>& s, int level)
 {
-  for (auto t : parent_levels_)
-    if (s.count(t.first))
-      t.second->graphicsItem()->setHighlighted(level);
+  for (auto e : s)
+    if (parent_levels_.count(e))
+      highlight(parent_levels_.at(e), parent_levels_selection_, level);
 }
 
 void SchemeGraphics::select_transistions(const std::set<Energy>& s, int level)
 {
-  for (auto t : transitions_)
-    if (s.count(t->energy()))
-      t->graphicsItem()->setHighlighted(level);
+  for (auto e : s)
+  {
+    if (!transition_index_.count(e))
+      continue;
+    auto t = transition_items_[transition_index_.at(e)];
+    if (t && t->graphicsItem()->isVisible())
+      highlight(t, transitions_selection_, level);
+  }
   highlight_coincidences();
 }
 
@@ -429,9 +535,9 @@ void SchemeGraphics::clickedGamma(TransitionItem *g)
     return;
 
   if (g->graphicsItem()->isHighlighted() == 1)
-    g->graphicsItem()->setHighlighted(0);
+    highlight(g, transitions_selection_, 0);
   else
-    g->graphicsItem()->setHighlighted(1);
+    highlight(g, transitions_selection_, 1);
 
   highlight_coincidences();
 
@@ -444,9 +550,9 @@ void SchemeGraphics::clickedParentLevel(LevelItem *e)
     return;
 
   if (e->graphicsItem()->isHighlighted())
-    e->graphicsItem()->setHighlighted(0);
+    highlight(e, parent_levels_selection_, 0);
   else
-    e->graphicsItem()->setHighlighted(1);
+    highlight(e, parent_levels_selection_, 1);
 
   triggerDataUpdate();
 }
@@ -457,9 +563,9 @@ void SchemeGraphics::clickedDaughterLevel(LevelItem *e)
     return;
 
   if (e->graphicsItem()->isHighlighted())
-    e->graphicsItem()->setHighlighted(0);
+    highlight(e, levels_selection_, 0);
   else
-    e->graphicsItem()->setHighlighted(1);
+    highlight(e, levels_selection_, 1);
 
   triggerDataUpdate();
 }
@@ -470,9 +576,9 @@ void SchemeGraphics::clickedFeeding(FeedingArrow* f)
     return;
 
   if (f->graphicsItem()->isHighlighted())
-    f->graphicsItem()->setHighlighted(0);
+    highlight(f, feedings_selection_, 0);
   else
-    f->graphicsItem()->setHighlighted(1);
+    highlight(f, feedings_selection_, 1);
 
   triggerDataUpdate();
 }
@@ -509,16 +615,22 @@ void SchemeGraphics::deselect_all()
 
 void SchemeGraphics::deselect_feedings()
 {
-  for (auto l : feeding_arrows_)
-    l.second->graphicsItem()->setHighlighted(0);
+  for (const auto& level : feedings_selection_)
+    for (auto e : level.second)
+      feeding_arrows_.at(e)->graphicsItem()->setHighlighted(0);
+  feedings_selection_.clear();
 }
 
 void SchemeGraphics::deselect_levels()
 {
-  for (auto l : daughter_levels_)
-    l.second->graphicsItem()->setHighlighted(0);
-  for (auto l : parent_levels_)
-    l.second->graphicsItem()->setHighlighted(0);
+  for (const auto& level : levels_selection_)
+    for (auto e : level.second)
+      daughter_levels_.at(e)->graphicsItem()->setHighlighted(0);
+  levels_selection_.clear();
+  for (const auto& level : parent_levels_selection_)
+    for (auto e : level.second)
+      parent_levels_.at(e)->graphicsItem()->setHighlighted(0);
+  parent_levels_selection_.clear();
 }
 
 void SchemeGraphics::deselect_nuclides()
@@ -533,44 +645,30 @@ void SchemeGraphics::deselect_nuclides()
 
 void SchemeGraphics::deselect_gammas()
 {
-  for (auto l : transitions_)
-    l->graphicsItem()->setHighlighted(0);
+  for (const auto& level : transitions_selection_)
+    for (auto e : level.second)
+      transition_items_[transition_index_.at(e)]->graphicsItem()->setHighlighted(0);
+  transitions_selection_.clear();
 }
 
 std::set<Energy> SchemeGraphics::selected_feedings(int level) const
 {
-  std::set<Energy> str;
-  for (auto t : feeding_arrows_)
-    if (t.second->graphicsItem()->isHighlighted() == level)
-      str.insert(t.first);
-  return str;
+  return selected(feedings_selection_, level);
 }
 
 std::set<Energy> SchemeGraphics::selected_levels(int level) const
 {
-  std::set<Energy> str;
-  for (auto t : daughter_levels_)
-    if (t.second->graphicsItem()->isHighlighted() == level)
-      str.insert(t.first);
-  return str;
+  return selected(levels_selection_, level);
 }
 
 std::set<Energy> SchemeGraphics::selected_parent_levels(int level) const
 {
-  std::set<Energy> str;
-  for (auto t : parent_levels_)
-    if (t.second->graphicsItem()->isHighlighted() == level)
-      str.insert(t.first);
-  return str;
+  return selected(parent_levels_selection_, level);
 }
 
 std::set<Energy> SchemeGraphics::selected_transistions(int level) const
 {
-  std::set<Energy> str;
-  for (auto t : transitions_)
-    if (t->graphicsItem()->isHighlighted() == level)
-      str.insert(t->energy());
-  return str;
+  return selected(transitions_selection_, level);
 }
 
 void SchemeGraphics::triggerDataUpdate()
@@ -580,7 +678,59 @@ void SchemeGraphics::triggerDataUpdate()
 
 void SchemeGraphics::setStyle(const SchemeVisualSettings &vis)
 {
+  TRACE_SCOPE("SchemeGraphics::setStyle");
   visual_settings_ = vis;
+  if (!scene_ || !scheme_.valid())
+    return;
+
+  if (daughter_)
+    daughter_->restyle(vis);
+  if (parent_)
+    parent_->restyle(vis);
+  for (auto l : daughter_levels_)
+    l.second->restyle(vis);
+  for (auto l : parent_levels_)
+    l.second->restyle(vis);
+  for (auto f : feeding_arrows_)
+    f.second->restyle(vis);
+  for (auto t : transitions_)
+    t->restyle(vis);
+
+  alignGraphicsItems();
+  scene_->setSceneRect(scene_->itemsBoundingRect());
+}
+
+void SchemeGraphics::setMinIntensity(double min_intensity)
+{
+  if (min_intensity == min_intensity_)
+    return;
+
+  TRACE_SCOPE("SchemeGraphics::setMinIntensity");
+  min_intensity_ = min_intensity;
+  if (!scene_ || !scheme_.valid())
+    return;
+
+  bool deselected = false;
+  for (auto t : transitions_)
+  {
+    bool show = passes(t);
+    if (t->graphicsItem()->isVisible() == show)
+      continue;
+    if (!show && (t->graphicsItem()->isHighlighted() == 1))
+      deselected = true;
+    if (!show)
+      highlight(t, transitions_selection_, 0);
+    t->graphicsItem()->setVisible(show);
+  }
+
+  // level heights and arrows stay, only the gamma columns move
+  alignTransitions(false);
+  alignLines();
+  highlight_coincidences();
+  scene_->setSceneRect(scene_->itemsBoundingRect());
+
+  if (deselected)
+    triggerDataUpdate();
 }
 
 void SchemeGraphics::set_highlight_cascade(bool h)
@@ -591,13 +741,49 @@ void SchemeGraphics::set_highlight_cascade(bool h)
 
 void SchemeGraphics::highlight_coincidences()
 {
-  std::set<Energy> intersect;
-  if (highlight_cascade_)
-    intersect = scheme_.daughterNuclide().coincidences(selected_transistions(1));
+  // intersect the coincidences of all selected transitions
+  std::vector<uint64_t> intersect;
+  if (highlight_cascade_ && !transition_items_.empty())
+  {
+    if (coincidence_rows_.empty())
+    {
+      CascadeClosure closure(scheme_.daughterNuclide());
+      coincidence_words_ = closure.words();
+      coincidence_rows_ = closure.coincidence_rows();
+    }
 
-  for (auto t : transitions_)
-    if (t->graphicsItem()->isHighlighted() != 1)
-      t->graphicsItem()->setHighlighted(
-            intersect.count(t->energy()) ? 2 : 0);
+    for (auto e : selected(transitions_selection_, 1))
+    {
+      size_t i = transition_index_.at(e);
+      const uint64_t* row = coincidence_rows_.data() + i * coincidence_words_;
+      if (intersect.empty())
+        intersect.assign(row, row + coincidence_words_);
+      else
+        for (size_t k = 0; k < coincidence_words_; ++k)
+          intersect[k] &= row[k];
+    }
+  }
+
+  // drop marks that no longer apply, then add the new ones
+  for (auto e : selected(transitions_selection_, 2))
+  {
+    size_t i = transition_index_.at(e);
+    if (intersect.empty() || !((intersect[i / 64] >> (i % 64)) & 1))
+      highlight(transition_items_[i], transitions_selection_, 0);
+  }
+  for (size_t k = 0; k < intersect.size(); ++k)
+  {
+    if (!intersect[k])
+      continue;
+    for (size_t b = 0; b < 64; ++b)
+    {
+      if (!((intersect[k] >> b) & 1))
+        continue;
+      auto t = transition_items_[k * 64 + b];
+      if (t && t->graphicsItem()->isVisible()
+          && (t->graphicsItem()->isHighlighted() != 1))
+        highlight(t, transitions_selection_, 2);
+    }
+  }
 }
 
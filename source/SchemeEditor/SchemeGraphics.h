@@ -5,6 +5,8 @@
 #include <QFont>
 #include <QMetaType>
 #include <NucData/DecayScheme.h>
+#include <cstdint>
+#include <vector>
 
 #include "NuclideItem.h"
 
@@ -25,11 +27,17 @@ public:
                         double min_intensity,
                         QObject *parent = 0);
 
+  // restyles the existing items in place once the scene is built
   void setStyle(const SchemeVisualSettings& vis);
+  // hides weaker transitions and re-lays out the gamma columns only
+  void setMinIntensity(double min_intensity);
 
   GraphicsScene* levelPlot();
 
   void setShadowEnabled(bool enable);
+  // level of detail: labels and effects are dropped below a readable size
+  void setViewScale(double scale);
+  void setDetailed(bool detailed);
 
   const DecayScheme& scheme() const;
 
@@ -56,6 +64,7 @@ public:
 
 signals:
   void enabledShadow(bool enable);
+  void detailChanged(bool detailed);
   void selectionChanged();
 
 private slots:
@@ -78,19 +87,39 @@ private:
   std::map<Energy, FeedingArrow*> feeding_arrows_;
   std::list<TransitionItem*> transitions_;
 
+  // transitions by their index in Nuclide::transitions()
+  std::vector<TransitionItem*> transition_items_;
+  std::map<Energy, size_t> transition_index_;
+  // per index: coincident transitions, built on first use
+  std::vector<uint64_t> coincidence_rows_;
+  size_t coincidence_words_ {0};
+
   bool parent_selected_ {false};
   bool daughter_selected_ {false};
   bool highlight_cascade_ {false};
 
+  // highlighted items by highlight level, kept in step with the items
+  using Selection = std::map<int, std::set<Energy>>;
+  Selection levels_selection_;
+  Selection parent_levels_selection_;
+  Selection feedings_selection_;
+  Selection transitions_selection_;
+  bool detailed_ {true};
+
   double min_intensity_;
+  double gammaspace_ {0};
 
   void alignGraphicsItems();
+  void alignLevels();
+  void alignTransitions(bool arrows);
+  void alignLines();
+  bool passes(const TransitionItem* transition) const;
 
   void addParent(Nuclide nuc);
   void addDaughter(Nuclide nuc);
   void addLevel(Level level);
   void addParentLevel(Level level);
-  void addTransition(Transition transition);
+  TransitionItem* addTransition(Transition transition);
   void connectItem(ClickableItem* item);
 
   void clickedGamma(TransitionItem *g);
@@ -107,4 +136,8 @@ private:
   void deselect_feedings();
 
   void highlight_coincidences();
+
+  template <typename Item>
+  void highlight(Item* item, Selection& selection, int level);
+  static std::set<Energy> selected(const Selection& selection, int level);
 };
@@ -0,0 +1,57 @@
+#include "SchemeRender.h"
+#include "SchemeGraphics.h"
+
+#include <QCoreApplication>
+#include <QPainter>
+#include <QPrinter>
+#include <QSvgGenerator>
+#include <qpagelayout.h>
+#include <qpagesize.h>
+
+bool render_svg(SchemeGraphics& scheme, const QString& file_name)
+{
+  QGraphicsScene* scene = scheme.levelPlot();
+  QRectF inrect = scene->sceneRect();
+  QRectF outrect = inrect.adjusted(-10.0, -10.0, 10.0, 10.0);
+
+  QSvgGenerator svgGen;
+  svgGen.setFileName(file_name);
+  svgGen.setSize(outrect.toRect().size());
+  svgGen.setViewBox(outrect);
+  svgGen.setTitle("Decay Level Scheme for the decay " + scheme.name());
+  svgGen.setDescription(QString::fromUtf8("This scheme was created using SchemeEditor"));
+
+  scheme.setShadowEnabled(false);
+  scheme.setDetailed(true);
+  QPainter painter;
+  if (!painter.begin(&svgGen))
+    return false;
+  scene->render(&painter, inrect, inrect);
+  return painter.end();
+}
+
+bool render_pdf(SchemeGraphics& scheme, const QString& file_name)
+{
+  const int scalefactor = 10;
+  const double margin = 3.0;
+
+  QGraphicsScene* scene = scheme.levelPlot();
+  QRectF inrect = scene->sceneRect();
+  QRectF outrect = inrect.adjusted(-margin*scalefactor, -margin*scalefactor, margin*scalefactor, margin*scalefactor);
+
+  QPrinter p(QPrinter::HighResolution);
+  p.setOutputFileName(file_name);
+  p.setPageMargins(QMarginsF(margin, margin, margin, margin), QPageLayout::Millimeter);
+  p.setOutputFormat(QPrinter::PdfFormat);
+  p.setPageSize(QPageSize(QSizeF(outrect.width() / scalefactor, outrect.height() / scalefactor), QPageSize::Millimeter));
+  p.setDocName("Decay Level Scheme for the decay " + scheme.name());
+  p.setCreator(QString("%1 %2 (%3)").arg(QCoreApplication::applicationName(), QCoreApplication::applicationVersion(), "SchemeEditorURL"));
+
+  scheme.setShadowEnabled(false);
+  scheme.setDetailed(true);
+  QPainter painter;
+  if (!painter.begin(&p))
+    return false;
+  scene->render(&painter);
+  return painter.end();
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QString>
+
+class SchemeGraphics;
+
+// Writes the scheme in full detail and without shadows, the same way for
+// the editor and for batch rendering. Shadows and level of detail are left
+// for the caller to restore.
+bool render_svg(SchemeGraphics& scheme, const QString& file_name);
+bool render_pdf(SchemeGraphics& scheme, const QString& file_name);
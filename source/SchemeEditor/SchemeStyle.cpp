@@ -0,0 +1,89 @@
+#include "SchemeStyle.h"
+
+#include <QFontMetrics>
+#include <QHash>
+#include <QSettings>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+struct FontMeasures
+{
+  explicit FontMeasures(const QFont& f)
+    : font(f), metrics(f) {}
+
+  QFont font;
+  QFontMetrics metrics;
+  QHash<QString, int> widths;
+};
+
+struct StyleCache
+{
+  std::unique_ptr<SchemeVisualSettings> settings;
+  // a scheme uses a handful of fonts, a linear search beats hashing them
+  std::vector<std::unique_ptr<FontMeasures>> fonts;
+};
+
+StyleCache& cache()
+{
+  static StyleCache c;
+  return c;
+}
+
+FontMeasures& measures(const QFont& font)
+{
+  auto& fonts = cache().fonts;
+  for (auto& f : fonts)
+    if (f->font == font)
+      return *f;
+  fonts.push_back(std::make_unique<FontMeasures>(font));
+  return *fonts.back();
+}
+
+}
+
+const SchemeVisualSettings& SchemeStyle::settings()
+{
+  auto& c = cache();
+  if (!c.settings)
+  {
+    QSettings s;
+    c.settings = std::make_unique<SchemeVisualSettings>(
+          SchemeVisualSettings::load(s));
+  }
+  return *c.settings;
+}
+
+void SchemeStyle::setSettings(const SchemeVisualSettings& vis)
+{
+  auto& c = cache();
+  c.settings = std::make_unique<SchemeVisualSettings>(vis);
+  c.fonts.clear();
+
+  QSettings s;
+  c.settings->save(s);
+}
+
+int SchemeStyle::height(const QFont& font)
+{
+  return measures(font).metrics.height();
+}
+
+int SchemeStyle::ascent(const QFont& font)
+{
+  return measures(font).metrics.ascent();
+}
+
+int SchemeStyle::width(const QFont& font, const QString& text)
+{
+  auto& m = measures(font);
+  auto it = m.widths.constFind(text);
+  if (it != m.widths.constEnd())
+    return it.value();
+  int w = m.metrics.horizontalAdvance(text);
+  m.widths.insert(text, w);
+  return w;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "SchemeVisualSettings.h"
+
+#include <QString>
+
+// Style shared by every scheme: the visual settings are read from QSettings
+// once, and font metrics and text widths are measured once per font, until
+// the preferences change. GUI thread only.
+class SchemeStyle
+{
+public:
+  static const SchemeVisualSettings& settings();
+  // saves new preferences and forgets everything measured for the old ones
+  static void setSettings(const SchemeVisualSettings& vis);
+
+  static int height(const QFont& font);
+  static int ascent(const QFont& font);
+  static int width(const QFont& font, const QString& text);
+};
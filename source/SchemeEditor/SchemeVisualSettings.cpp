@@ -13,6 +13,8 @@ SchemeVisualSettings::SchemeVisualSettings()
   feedArrowPen.setCapStyle(Qt::FlatCap);
   gammaPen.setWidthF(1.0);
   gammaPen.setCapStyle(Qt::FlatCap);
+
+  update_fonts();
 }
 
 SchemeVisualSettings SchemeVisualSettings::load(QSettings& s)
@@ -52,6 +54,7 @@ void SchemeVisualSettings::setStyle(const QFont &fontfamily,
 {
   font_ = fontfamily;
   font_.setPixelSize(sizePx);
+  update_fonts();
 }
 
 QColor SchemeVisualSettings::inactive_color() const
@@ -115,49 +118,65 @@ int SchemeVisualSettings::font_size() const
   return font_.pixelSize();
 }
 
-QFont SchemeVisualSettings::stdFont() const
+const QFont& SchemeVisualSettings::stdFont() const
 {
   return font_;
 }
 
-QFont SchemeVisualSettings::gammaFont() const
+const QFont& SchemeVisualSettings::gammaFont() const
 {
   return font_;
 }
 
-QFont SchemeVisualSettings::stdBoldFont() const
+const QFont& SchemeVisualSettings::stdBoldFont() const
 {
-  auto ret = font_;
-  ret.setBold(true);
-  return ret;
+  return std_bold_font_;
 }
 
-QFont SchemeVisualSettings::nucFont() const
+const QFont& SchemeVisualSettings::nucFont() const
 {
-  auto ret = font_;
-  ret.setPixelSize(font_.pixelSize() * 2);
-  ret.setBold(true);
-  return ret;
+  return nuc_font_;
 }
 
-QFont SchemeVisualSettings::nucIndexFont() const
+const QFont& SchemeVisualSettings::nucIndexFont() const
 {
-  auto ret = font_;
-  ret.setPixelSize(font_.pixelSize() * 1.2);
-  ret.setBold(true);
-  return ret;
+  return nuc_index_font_;
 }
 
-QFont SchemeVisualSettings::parentHlFont() const
+const QFont& SchemeVisualSettings::parentHlFont() const
 {
-  auto ret = font_;
-  ret.setPixelSize(font_.pixelSize() * 1.2);
-  return ret;
+  return parent_hl_font_;
 }
 
-QFont SchemeVisualSettings::feedIntensityFont() const
+const QFont& SchemeVisualSettings::feedIntensityFont() const
 {
-  auto ret = font_;
-  ret.setItalic(true);
-  return ret;
+  return feed_intensity_font_;
+}
+
+void SchemeVisualSettings::update_fonts()
+{
+  // default-constructed settings have a point-sized font
+  auto scaled = [this](double factor)
+  {
+    auto ret = font_;
+    if (font_.pixelSize() > 0)
+      ret.setPixelSize(font_.pixelSize() * factor);
+    else
+      ret.setPointSizeF(font_.pointSizeF() * factor);
+    return ret;
+  };
+
+  std_bold_font_ = font_;
+  std_bold_font_.setBold(true);
+
+  nuc_font_ = scaled(2);
+  nuc_font_.setBold(true);
+
+  nuc_index_font_ = scaled(1.2);
+  nuc_index_font_.setBold(true);
+
+  parent_hl_font_ = scaled(1.2);
+
+  feed_intensity_font_ = font_;
+  feed_intensity_font_.setItalic(true);
 }
@@ -34,14 +34,14 @@ struct SchemeVisualSettings
     void set_hover_color(QColor);
     void set_nuclide_color(QColor);
 
-    // style
-    QFont stdFont() const;
-    QFont stdBoldFont() const;
-    QFont nucFont() const;
-    QFont nucIndexFont() const;
-    QFont parentHlFont() const;
-    QFont feedIntensityFont() const;
-    QFont gammaFont() const;
+    // style, derived from font() whenever it is set
+    const QFont& stdFont() const;
+    const QFont& stdBoldFont() const;
+    const QFont& nucFont() const;
+    const QFont& nucIndexFont() const;
+    const QFont& parentHlFont() const;
+    const QFont& feedIntensityFont() const;
+    const QFont& gammaFont() const;
 
     QPen levelPen, stableLevelPen, feedArrowPen, gammaPen;
 
@@ -65,6 +65,10 @@ struct SchemeVisualSettings
   private:
 
     QFont font_;
+    QFont std_bold_font_, nuc_font_, nuc_index_font_,
+          parent_hl_font_, feed_intensity_font_;
+
+    void update_fonts();
 
     QColor inactive_color_ {Qt::black};
     QColor selected_color_ {QColor(224, 186, 100, 180)};
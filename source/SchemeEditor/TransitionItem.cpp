@@ -30,7 +30,7 @@ TransitionItem::TransitionItem()
 {}
 
 TransitionItem::TransitionItem(Transition transition,
-                               SchemeVisualSettings vis,
+                               const SchemeVisualSettings& vis,
                                QGraphicsScene *scene)
   : TransitionItem()
 {
@@ -40,10 +40,7 @@ TransitionItem::TransitionItem(Transition transition,
 
   // group origin is set to the start level!
   item = new ActiveGraphicsItemGroup(this);
-  item->setActiveColor(0, vis.inactive_color());
-  item->setActiveColor(1, vis.selected_color());
-  item->setActiveColor(2, vis.implicated_color());
-  item->setHoverColor(vis.hover_color());
+  setColors(vis.inactive_color(), vis);
   scene->addItem(item);
 
   arrow_head_ = new QGraphicsPolygonItem(initArrowHead(arrowHeadWidth));
@@ -73,13 +70,7 @@ TransitionItem::TransitionItem(Transition transition,
   text_->document()->setDocumentMargin(0.0);
   text_->setHtml(textstr);
 //  new QGraphicsRectItem(text_->boundingRect(), text_);
-  double textheight = text_->boundingRect().height();
-  text_->setPos(0.0, -textheight);
-  text_->setTransformOriginPoint(0.0, 0.5*textheight);
-  text_->setRotation(textAngle);
-  min_x_distance_ = std::abs(textheight / std::sin(-textAngle/180.0*M_PI));
-  text_->moveBy(0.5*textheight*std::sin(-textAngle/180.0*M_PI)
-                - 0.5*min_x_distance_, 0.0);
+  placeText();
   item->addToGroup(text_);
 
   click_area_ = new QGraphicsRectItem(-0.5*min_x_distance_, 0.0,
@@ -101,6 +92,41 @@ TransitionItem::~TransitionItem()
 {
 }
 
+void TransitionItem::placeText()
+{
+  double textheight = text_->boundingRect().height();
+  text_->setRotation(0.0);
+  text_->setPos(0.0, -textheight);
+  text_->setTransformOriginPoint(0.0, 0.5*textheight);
+  text_->setRotation(textAngle);
+  min_x_distance_ = std::abs(textheight / std::sin(-textAngle/180.0*M_PI));
+  text_->moveBy(0.5*textheight*std::sin(-textAngle/180.0*M_PI)
+                - 0.5*min_x_distance_, 0.0);
+}
+
+void TransitionItem::restyle(const SchemeVisualSettings &vis)
+{
+  // children leave the group in scene coordinates, so lay out at the origin;
+  // the next alignment moves the group back into place
+  item->setPos(0.0, 0.0);
+  setColors(vis.inactive_color(), vis);
+
+  pen_ = vis.gammaPen;
+  arrow_->setPen(pen_);
+  arrow_head_->setBrush(QBrush(pen_.color()));
+  arrow_base_->setBrush(QBrush(pen_.color()));
+
+  item->removeFromGroup(text_);
+  text_->setFont(vis.gammaFont());
+  placeText();
+  item->addToGroup(text_);
+}
+
+const Transition& TransitionItem::transition() const
+{
+  return transition_;
+}
+
 double TransitionItem::intensity() const
 {
   if (transition_.intensity().hasFiniteValue())
@@ -163,6 +189,16 @@ double TransitionItem::widthFromOrigin() const
   return item->childrenBoundingRect().right();
 }
 
+double TransitionItem::heightAboveOrigin() const
+{
+  return -item->childrenBoundingRect().top();
+}
+
+double TransitionItem::labelSlope()
+{
+  return std::tan(-textAngle/180.0*M_PI);
+}
+
 QPen TransitionItem::pen() const
 {
   return pen_;
@@ -22,19 +22,28 @@ public:
 
   TransitionItem();
   TransitionItem(Transition transition,
-                 SchemeVisualSettings vis,
+                 const SchemeVisualSettings& vis,
                  QGraphicsScene *scene);
 
   virtual ~TransitionItem();
 
+  // applies pens, colors and fonts of a new style to the existing items
+  void restyle(const SchemeVisualSettings &vis);
+
   void updateArrow(double arrowDestY, [[maybe_unused]] double max_intensity);
   double minimalXDistance() const;
   // Distance between origin and right edge of the bounding rect
   double widthFromOrigin() const;
+  // Distance between origin and top edge of the bounding rect
+  double heightAboveOrigin() const;
+  // Rise of the slanted label per unit of horizontal distance
+  static double labelSlope();
 
   double intensity() const;
   QPen pen() const;
 
+  const Transition& transition() const;
+
   //deprecate, return underlying transition instead
   Energy energy() const;
   Energy from() const;
@@ -53,6 +62,8 @@ private:
 
   Transition transition_;
 
+  void placeText();
+
 private:
   static const double textAngle;
   static const double arrowHeadLength;
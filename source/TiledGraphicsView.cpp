@@ -0,0 +1,140 @@
+#include "TiledGraphicsView.h"
+
+#include <util/trace.h>
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <qmath.h>
+
+uint qHash(const TiledGraphicsView::TileKey &key, uint seed)
+{
+  return qHash(key.sx, seed) ^ qHash(key.sy, seed)
+      ^ qHash(key.column, seed) ^ (qHash(key.row, seed) << 1);
+}
+
+TiledGraphicsView::TiledGraphicsView(QWidget *parent)
+  : QGraphicsView(parent)
+  , tiles_(128 * 1024)
+{}
+
+void TiledGraphicsView::setTileCacheEnabled(bool enabled)
+{
+  if (enabled == tiles_enabled_)
+    return;
+  tiles_enabled_ = enabled;
+  clearTileCache();
+  viewport()->update();
+}
+
+void TiledGraphicsView::setTileCacheLimit(int kb)
+{
+  // room for a screenful of tiles at least
+  tiles_.setMaxCost(qMax(kb, 16 * 1024));
+}
+
+void TiledGraphicsView::clearTileCache()
+{
+  tiles_.clear();
+}
+
+void TiledGraphicsView::watchScene()
+{
+  if (scene() == tiled_scene_)
+    return;
+  if (tiled_scene_)
+    disconnect(tiled_scene_, 0, this, 0);
+  clearTileCache();
+  tiled_scene_ = scene();
+  if (!tiled_scene_)
+    return;
+  connect(tiled_scene_, SIGNAL(changed(QList<QRectF>)),
+          this, SLOT(sceneChanged(QList<QRectF>)));
+  connect(tiled_scene_, SIGNAL(sceneRectChanged(QRectF)),
+          this, SLOT(clearTileCache()));
+}
+
+void TiledGraphicsView::sceneChanged(const QList<QRectF> &region)
+{
+  for (const auto &key : tiles_.keys())
+  {
+    QRectF r = tileSceneRect(key);
+    for (const auto &changed : region)
+    {
+      if (r.intersects(changed))
+      {
+        tiles_.remove(key);
+        break;
+      }
+    }
+  }
+}
+
+QRectF TiledGraphicsView::tileSceneRect(const TileKey &key) const
+{
+  // widened by the pixels that antialiasing may spill over
+  return QRectF((key.column * tile_size - 2) / key.sx,
+                (key.row * tile_size - 2) / key.sy,
+                (tile_size + 4) / key.sx,
+                (tile_size + 4) / key.sy);
+}
+
+QPixmap *TiledGraphicsView::tile(const TileKey &key)
+{
+  const qreal dpr = viewport()->devicePixelRatioF();
+  QPixmap *ret = tiles_.object(key);
+  if (ret && (ret->devicePixelRatioF() == dpr))
+    return ret;
+
+  TRACE_SCOPE("TiledGraphicsView::tile");
+  ret = new QPixmap(QSize(tile_size, tile_size) * dpr);
+  ret->setDevicePixelRatio(dpr);
+  ret->fill(viewport()->palette().color(viewport()->backgroundRole()));
+  {
+    QPainter painter(ret);
+    painter.setRenderHints(renderHints());
+    QRectF target(0, 0, tile_size, tile_size);
+    QRectF source(key.column * tile_size / key.sx, key.row * tile_size / key.sy,
+                  tile_size / key.sx, tile_size / key.sy);
+    scene()->render(&painter, target, source, Qt::IgnoreAspectRatio);
+  }
+
+  int cost = ret->width() * ret->height() * ret->depth() / 8 / 1024;
+  if (!tiles_.insert(key, ret, cost))
+    return nullptr;
+  return ret;
+}
+
+void TiledGraphicsView::paintEvent(QPaintEvent *event)
+{
+  const QTransform vt = viewportTransform();
+  if (!tiles_enabled_ || !scene() || (vt.type() > QTransform::TxScale)
+      || (vt.m11() <= 0) || (vt.m22() <= 0))
+  {
+    QGraphicsView::paintEvent(event);
+    return;
+  }
+
+  watchScene();
+  TRACE_SCOPE("TiledGraphicsView::paintEvent");
+
+  // tiles are laid out from the scene origin, so that scrolling
+  // only moves them around
+  const QPoint origin = vt.map(QPointF(0, 0)).toPoint();
+  const QRect exposed = event->rect().translated(-origin);
+  const int left = qFloor(qreal(exposed.left()) / tile_size);
+  const int right = qFloor(qreal(exposed.right()) / tile_size);
+  const int top = qFloor(qreal(exposed.top()) / tile_size);
+  const int bottom = qFloor(qreal(exposed.bottom()) / tile_size);
+
+  QPainter painter(viewport());
+  for (int row = top; row <= bottom; ++row)
+  {
+    for (int column = left; column <= right; ++column)
+    {
+      TileKey key {vt.m11(), vt.m22(), column, row};
+      QPixmap *p = tile(key);
+      if (p)
+        painter.drawPixmap(origin + QPoint(column, row) * tile_size, *p);
+    }
+  }
+}
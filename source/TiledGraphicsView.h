@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QCache>
+#include <QGraphicsView>
+#include <QPixmap>
+#include <QPointer>
+
+// A graphics view that paints its scene from a cache of raster tiles.
+//
+// Tiles are laid out in view pixels at the current zoom, independent of
+// scrolling, so panning only copies pixmaps that are already drawn. When
+// items change, only the tiles under the changed scene rectangles are drawn
+// again; a new scene or scene rect drops the whole cache. Tiles of recent
+// zoom levels are kept, up to the cache limit, for zooming back and forth.
+//
+// Views that are rotated or sheared are painted the usual way.
+
+class TiledGraphicsView : public QGraphicsView
+{
+  Q_OBJECT
+public:
+  explicit TiledGraphicsView(QWidget *parent = 0);
+
+  void setTileCacheEnabled(bool enabled);
+  bool tileCacheEnabled() const { return tiles_enabled_; }
+
+  // in kilobytes
+  void setTileCacheLimit(int kb);
+
+public slots:
+  void clearTileCache();
+
+protected:
+  void paintEvent(QPaintEvent *event) Q_DECL_OVERRIDE;
+
+private slots:
+  void sceneChanged(const QList<QRectF> &region);
+
+private:
+  struct TileKey
+  {
+    qreal sx, sy;
+    int column, row;
+
+    bool operator==(const TileKey &other) const
+    {
+      return (sx == other.sx) && (sy == other.sy)
+          && (column == other.column) && (row == other.row);
+    }
+  };
+  friend uint qHash(const TileKey &key, uint seed);
+
+  static const int tile_size = 256;
+
+  bool tiles_enabled_ {true};
+  QCache<TileKey, QPixmap> tiles_;
+  QPointer<QGraphicsScene> tiled_scene_;
+
+  void watchScene();
+  QRectF tileSceneRect(const TileKey &key) const;
+  QPixmap *tile(const TileKey &key);
+};
@@ -0,0 +1,173 @@
+#include <ensdf/Parser.h>
+
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+// Times single-threaded parsing of whole mass chains, the way nuclei-export
+// reads them: every decay of every daughter. Without a folder, synthetic
+// chains are written to a temporary one first. Log messages go to a null
+// sink, so the level shows what preparing them costs.
+//
+//   nuclei-bench-ingest [-d ensdf folder] [-l log level] [-r repeats]
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string field(std::string line, size_t column, const std::string& value)
+{
+  if (line.size() < column - 1 + value.size())
+    line.resize(column - 1 + value.size(), ' ');
+  line.replace(column - 1, value.size(), value);
+  return line;
+}
+
+std::string record(const std::string& nucid, char type)
+{
+  std::string ret(80, ' ');
+  ret = field(ret, 1, nucid);
+  ret[7] = type;
+  return ret;
+}
+
+std::string number(double v, int precision)
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.*f", precision, v);
+  return buf;
+}
+
+// one B- decay dataset with 121 levels and about 380 gammas, like a
+// well-studied rare earth chain
+void write_chain(const fs::path& file, uint16_t A, std::mt19937& rng)
+{
+  const std::string daughter = std::to_string(A) + "SM";
+  const std::string parent = std::to_string(A) + "EU";
+  std::ofstream os(file);
+
+  os << field(record(daughter, ' '), 10, parent + " B- DECAY (13.537 Y)") << "\n";
+  auto p = record(parent, 'P');
+  p = field(p, 10, "0.0");
+  p = field(p, 22, "3-");
+  p = field(p, 40, "13.537 Y");
+  p = field(p, 50, "6");
+  p = field(p, 65, "1874.3");
+  p = field(p, 75, "7");
+  os << p << "\n";
+  os << field(field(record(daughter, 'N'), 10, "1.0"), 22, "1.0") << "\n";
+
+  std::uniform_real_distribution<double> gap(5.0, 25.0);
+  std::uniform_real_distribution<double> intensity(0.1, 20.0);
+  std::uniform_int_distribution<int> branches(1, 6);
+  std::vector<double> levels;
+  double energy = 0.0;
+  for (int l = 0; l < 121; ++l)
+  {
+    os << field(field(record(daughter, 'L'), 10, number(energy, 1)), 22, "2+") << "\n";
+    int n = std::min<int>(branches(rng), int(levels.size()));
+    for (int g = 0; g < n; ++g)
+    {
+      double to = levels[levels.size() - 1 - (rng() % levels.size())];
+      auto line = record(daughter, 'G');
+      line = field(line, 10, number(energy - to, 2));
+      line = field(line, 22, number(intensity(rng), 2));
+      line = field(line, 32, "E2");
+      os << line << "\n";
+    }
+    levels.push_back(energy);
+    energy += gap(rng);
+  }
+  os << std::string(80, ' ') << "\n";
+}
+
+fs::path write_synthetic(size_t chains)
+{
+  auto dir = fs::temp_directory_path()
+      / ("nuclei-bench-ingest-" + std::to_string(std::random_device()()));
+  fs::create_directories(dir);
+  std::mt19937 rng(152);
+  for (size_t i = 0; i < chains; ++i)
+  {
+    uint16_t A = uint16_t(100 + i);
+    write_chain(dir / ("ensdf." + std::to_string(A)), A, rng);
+  }
+  return dir;
+}
+
+size_t ingest(const std::string& directory, const std::set<uint16_t>& masses)
+{
+  size_t schemes = 0;
+  for (auto A : masses)
+  {
+    DaughterParser dp(A, directory);
+    for (const auto& daughter : dp.daughters())
+      for (const auto& name : dp.decays(daughter))
+        schemes += dp.decay(daughter, name, false).valid();
+  }
+  return schemes;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  std::string directory;
+  std::string level = "err";
+  int repeats = 5;
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    std::string arg = argv[i];
+    if (arg == "-d")
+      directory = argv[i + 1];
+    else if (arg == "-l")
+      level = argv[i + 1];
+    else if (arg == "-r")
+      repeats = std::max(1, std::atoi(argv[i + 1]));
+    else
+    {
+      std::fprintf(stderr, "usage: %s [-d ensdf folder] [-l log level] [-r repeats]\n",
+                   argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto logger = spdlog::null_logger_mt("nuclei_bench");
+  logger->set_level(spdlog::level::from_str(level));
+  spdlog::set_default_logger(logger);
+
+  fs::path synthetic;
+  if (directory.empty())
+  {
+    synthetic = write_synthetic(100);
+    directory = synthetic.string();
+  }
+
+  ENSDFParser parser(directory);
+  size_t schemes = 0;
+  double best = 0;
+  for (int r = 0; r < repeats; ++r)
+  {
+    auto start = std::chrono::steady_clock::now();
+    schemes = ingest(directory, parser.masses());
+    double s = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+    best = (r == 0) ? s : std::min(best, s);
+  }
+
+  std::printf("%zu chains, %zu schemes, log level %s: %.3f s best of %d\n",
+              parser.masses().size(), schemes, level.c_str(), best, repeats);
+
+  if (!synthetic.empty())
+    fs::remove_all(synthetic);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <SchemeEditor/ColumnPacker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Times the packing of gamma transitions into columns on a synthetic
+// scheme, with label sizes as drawn by TransitionItem.
+//
+//   nuclei-bench-layout [levels [gammas [repeats]]]
+
+namespace
+{
+
+// TransitionItem labels are rotated by 60 degrees
+const double label_angle = 60.0 / 180.0 * M_PI;
+const double text_height = 14.0;
+
+std::vector<ColumnFootprint> synthetic_scheme(int levels, int gammas)
+{
+  std::mt19937 rng(152);
+
+  // levels climb by 20 to 60 pixels
+  std::vector<double> y(levels, 0.0);
+  std::uniform_real_distribution<double> gap(20.0, 60.0);
+  for (int i = 1; i < levels; ++i)
+    y[i] = y[i - 1] + gap(rng);
+
+  // most gammas feed nearby levels, labels are 40 to 120 pixels long
+  std::uniform_int_distribution<int> from(1, levels - 1);
+  std::geometric_distribution<int> drop(0.15);
+  std::uniform_real_distribution<double> label(40.0, 120.0);
+  std::vector<ColumnFootprint> ret;
+  for (int i = 0; i < gammas; ++i)
+  {
+    int f = from(rng);
+    int t = std::max(0, f - 1 - drop(rng));
+    ColumnFootprint fp;
+    fp.low = y[t];
+    fp.base = y[f];
+    fp.high = fp.base + label(rng) * std::sin(label_angle);
+    ret.push_back(fp);
+  }
+  return ret;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  int levels = (argc > 1) ? std::atoi(argv[1]) : 400;
+  int gammas = (argc > 2) ? std::atoi(argv[2]) : 1500;
+  int repeats = (argc > 3) ? std::atoi(argv[3]) : 200;
+  if ((levels < 2) || (gammas < 1) || (repeats < 1))
+  {
+    std::fprintf(stderr, "usage: %s [levels [gammas [repeats]]]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto footprints = synthetic_scheme(levels, gammas);
+  const double pitch = text_height / std::sin(label_angle);
+  const double step = pitch * std::tan(label_angle);
+
+  std::vector<int> columns;
+  std::vector<double> times;
+  for (int r = 0; r < repeats; ++r)
+  {
+    auto start = std::chrono::steady_clock::now();
+    columns = packColumns(footprints, pitch, step);
+    times.push_back(std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start).count());
+  }
+  std::sort(times.begin(), times.end());
+
+  int count = 0;
+  for (auto c : columns)
+    count = std::max(count, c + 1);
+  std::printf("%d levels, %d gammas: %d columns, "
+              "%.3f ms median, %.3f ms min over %d layouts\n",
+              levels, gammas, count, times[times.size() / 2], times.front(),
+              repeats);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include <ensdf/DictionaryTrie.h>
+#include <algorithm>
+
+DictionaryTrie::DictionaryTrie()
+{
+  nodes_.emplace_back();
+  root_.fill(none);
+}
+
+void DictionaryTrie::insert(const std::string& key, const std::string& value)
+{
+  if (key.empty())
+    return;
+
+  uint32_t node = 0;
+  for (char c : key)
+  {
+    uint32_t n = next(node, c);
+    if (n == none)
+    {
+      n = uint32_t(nodes_.size());
+      nodes_.emplace_back();
+      auto& edges = nodes_[node].next;
+      edges.insert(std::upper_bound(edges.begin(), edges.end(),
+                                    std::make_pair(c, uint32_t(0)),
+                                    [](const std::pair<char, uint32_t>& a,
+                                       const std::pair<char, uint32_t>& b)
+                                    { return a.first < b.first; }),
+                   {c, n});
+      if (!node)
+        root_[static_cast<unsigned char>(c)] = n;
+    }
+    node = n;
+  }
+
+  if (nodes_[node].value == none)
+  {
+    nodes_[node].value = uint32_t(values_.size());
+    values_.push_back(value);
+  }
+  else
+    values_[nodes_[node].value] = value;
+}
+
+uint32_t DictionaryTrie::next(uint32_t node, char c) const
+{
+  if (!node)
+    return root_[static_cast<unsigned char>(c)];
+  const auto& edges = nodes_[node].next;
+  auto it = std::lower_bound(edges.begin(), edges.end(), c,
+                             [](const std::pair<char, uint32_t>& a, char b)
+                             { return a.first < b; });
+  if ((it == edges.end()) || (it->first != c))
+    return none;
+  return it->second;
+}
+
+const std::string* DictionaryTrie::find(std::string_view key) const
+{
+  uint32_t node = 0;
+  for (char c : key)
+  {
+    node = next(node, c);
+    if (node == none)
+      return nullptr;
+  }
+  if (!node || (nodes_[node].value == none))
+    return nullptr;
+  return &values_[nodes_[node].value];
+}
+
+size_t DictionaryTrie::match(std::string_view text, size_t pos,
+                             const std::string*& value) const
+{
+  size_t ret {0};
+  uint32_t node = 0;
+  for (size_t i = pos; i < text.size(); ++i)
+  {
+    node = next(node, text[i]);
+    if (node == none)
+      break;
+    if (nodes_[node].value != none)
+    {
+      ret = i - pos + 1;
+      value = &values_[nodes_[node].value];
+    }
+  }
+  return ret;
+}
+
+std::string DictionaryTrie::replace(std::string_view text) const
+{
+  std::string ret;
+  replace(text, ret);
+  return ret;
+}
+
+void DictionaryTrie::replace(std::string_view text, std::string& out) const
+{
+  out.reserve(out.size() + text.size() + text.size() / 4);
+  size_t copied {0};
+  for (size_t i = 0; i < text.size();)
+  {
+    const std::string* value {nullptr};
+    size_t len = match(text, i, value);
+    if (!len)
+    {
+      ++i;
+      continue;
+    }
+    out.append(text.data() + copied, i - copied);
+    out.append(*value);
+    i += len;
+    copied = i;
+  }
+  out.append(text.data() + copied, text.size() - copied);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+// Compiled set of string substitutions.
+// Keys are stored in a trie with sorted edge lists, the root fans out through
+// a direct table since most text positions fail on their first character.
+class DictionaryTrie
+{
+public:
+  DictionaryTrie();
+
+  void insert(const std::string& key, const std::string& value);
+
+  // value for an exact key, nullptr if there is none
+  const std::string* find(std::string_view key) const;
+
+  // length of the longest key starting at text[pos], 0 if none
+  size_t match(std::string_view text, size_t pos,
+               const std::string*& value) const;
+
+  // leftmost-longest substitution of all keys in a single pass
+  std::string replace(std::string_view text) const;
+  void replace(std::string_view text, std::string& out) const;
+
+private:
+  static constexpr uint32_t none = UINT32_MAX;
+
+  struct Node
+  {
+    std::vector<std::pair<char, uint32_t>> next;
+    uint32_t value {none};
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<std::string> values_;
+  std::array<uint32_t, 256> root_;
+
+  uint32_t next(uint32_t node, char c) const;
+};
@@ -6,6 +6,7 @@
 #include <util/UTF_extensions.h>
 //#include "qpx_util.h"
 #include <util/logger.h>
+#include <cstring>
 
 #define RGX_SPIN "\\d+(?:/\\d+)?"
 #define RGX_QSPIN "[\\[\\(~]?" RGX_SPIN "[\\]\\)]?"
@@ -25,6 +26,23 @@ using dlim = std::numeric_limits<double>;
 //using d_inf = std::numeric_limits<double>::infinity();
 //using d_NaN = std::numeric_limits<double>::quiet_NaN();
 
+std::string_view field(std::string_view line, size_t pos, size_t len)
+{
+  if (pos >= line.size())
+    return std::string_view();
+  return line.substr(pos, len);
+}
+
+std::string_view trimmed_field(std::string_view line, size_t pos, size_t len)
+{
+  return trim_view(field(line, pos, len));
+}
+
+std::string field_str(std::string_view line, size_t pos, size_t len)
+{
+  return std::string(trimmed_field(line, pos, len));
+}
+
 bool is_uncertainty_id(const std::string& str)
 {
   return (str == "LT" ||
@@ -107,7 +125,7 @@ Uncert::UncertaintyType parse_uncert_type(const std::string& uncert)
 }
 
 
-Uncert parse_norm(std::string val, std::string uncert)
+Uncert parse_norm(std::string_view val, std::string_view uncert)
 {
   auto ret = parse_val_uncert(val, uncert);
   if (ret.sign() & Uncert::MagnitudeDefined)
@@ -115,45 +133,59 @@ Uncert parse_norm(std::string val, std::string uncert)
   return ret;
 }
 
-Energy parse_energy(std::string val, std::string uncert)
+Energy parse_energy(std::string_view val, std::string_view uncert)
 {
   return Energy(parse_val_uncert(val, uncert));
 }
 
-Uncert parse_val_uncert(std::string val, std::string uncert)
+static std::string without(std::string_view s, const char* chars)
+{
+  std::string ret;
+  for (char c : s)
+    if (!std::strchr(chars, c))
+      ret += c;
+  return ret;
+}
+
+Uncert parse_val_uncert(std::string_view val, std::string_view uncert)
 {
-  boost::trim(val);
-  boost::trim(uncert);
+  val = trim_view(val);
+  uncert = trim_view(uncert);
 
   bool flag_tentative = false;
   bool flag_theoretical = false;
-  if (boost::contains(val, "(") || boost::contains(val, ")")) //what if sign only?
+  std::string stripped;
+  if (val.find_first_of("()") != std::string_view::npos) //what if sign only?
   {
-    boost::replace_all(val, "(", "");
-    boost::replace_all(val, ")", "");
+    stripped = without(val, "()");
+    val = stripped;
     flag_tentative = true;
   }
-  else if (boost::contains(val, "[") || boost::contains(val, "]")) //what if sign only?
+  else if (val.find_first_of("[]") != std::string_view::npos) //what if sign only?
   {
-    boost::replace_all(val, "[", "");
-    boost::replace_all(val, "]", "");
+    stripped = without(val, "[]");
+    val = stripped;
     flag_theoretical = true;
   }
 
-  if (val.empty() || !is_number(val))
+  double value;
+  if (val.empty() || !parse_double(val, value))
     return Uncert();
 
-  Uncert result(std::stod(val), sig_digits(val), Uncert::UndefinedSign);
+  Uncert result(value, sig_digits(val), Uncert::UndefinedSign);
   double val_order = get_precision(val);
 
-  if (boost::contains(val, "+") || boost::contains(val, "-"))
+  if (val.find_first_of("+-") != std::string_view::npos)
     result.setSign(Uncert::SignMagnitudeDefined);
   else
     result.setSign(Uncert::MagnitudeDefined);
 
   // parse uncertainty
   // symmetric or special case (consider symmetric if not + and - are both contained in string)
-  if ( !( boost::contains(uncert,"+") && boost::contains(uncert, "-"))
+  double uncert_value;
+  bool uncert_number = parse_double(uncert, uncert_value);
+  if ( !( (uncert.find('+') != std::string_view::npos)
+          && (uncert.find('-') != std::string_view::npos))
        || flag_tentative )
   {
     if (uncert == "LT")
@@ -164,7 +196,7 @@ Uncert parse_val_uncert(std::string val, std::string uncert)
       result.setUncertainty(-dlim::infinity(), 0.0, Uncert::LessEqual);
     else if (uncert == "GE")
       result.setUncertainty(0.0, dlim::infinity(), Uncert::GreaterEqual);
-    else if (uncert == "AP" || uncert.empty() || !is_number(uncert) || flag_tentative)
+    else if (uncert == "AP" || uncert.empty() || !uncert_number || flag_tentative)
       result.setUncertainty(dlim::quiet_NaN(), dlim::quiet_NaN(), Uncert::Approximately);
     else if (uncert == "CA" || flag_theoretical)
       result.setUncertainty(0.0, 0.0, Uncert::Calculated);
@@ -172,8 +204,9 @@ Uncert parse_val_uncert(std::string val, std::string uncert)
       result.setUncertainty(0.0, 0.0, Uncert::Systematics);
     else {
       // determine significant figure
-      if (!uncert.empty() && is_number(uncert))
-        result.setSymmetricUncertainty(val_order * std::stoi(uncert));
+      int digits {0};
+      if (uncert_number && parse_int(uncert, digits))
+        result.setSymmetricUncertainty(val_order * digits);
       else
         result.setUncertainty(dlim::quiet_NaN(),
                               dlim::quiet_NaN(),
@@ -183,18 +216,18 @@ Uncert parse_val_uncert(std::string val, std::string uncert)
   // asymmetric case
   else
   {
+    static const boost::regex expr{"^\\+([^\\-]+)\\-(.*)$"};
+    static const boost::regex inv_expr{"^\\-([^\\+]+)\\+(.*)$"};
     std::string uposstr, unegstr;
-    boost::algorithm::replace_all(uncert, " ", "");
-    boost::regex expr{"^\\+([^\\-]+)\\-(.*)$"};
-    boost::regex inv_expr{"^\\-([^\\+]+)\\+(.*)$"};
+    std::string asym = without(uncert, " ");
     boost::smatch what;
-    if (boost::regex_match(uncert, what, expr) &&
+    if (boost::regex_match(asym, what, expr) &&
         (what.size() == 3))
     {
       uposstr = what[1];
       unegstr = what[2];
     }
-    else if (boost::regex_match(uncert, what, inv_expr) &&
+    else if (boost::regex_match(asym, what, inv_expr) &&
              (what.size() == 3))
     {
       unegstr = what[1];
@@ -207,13 +240,15 @@ Uncert parse_val_uncert(std::string val, std::string uncert)
     boost::trim(uposstr);
     boost::trim(unegstr);
 
-    if (!uposstr.empty() && is_number(uposstr))
-      upositive = std::stoi(uposstr);
+    double number;
+    int digits {0};
+    if (parse_double(uposstr, number) && parse_int(uposstr, digits))
+      upositive = digits;
     else if (uposstr == "|@")
       upositive = dlim::infinity();
 
-    if (!unegstr.empty() && is_number(unegstr))
-      unegative = std::stoi(unegstr);
+    if (parse_double(unegstr, number) && parse_int(unegstr, digits))
+      unegative = digits;
     else if (unegstr == "|@")
       unegative = -1 * dlim::infinity();
 
@@ -302,7 +337,7 @@ std::string strip_qualifiers(const std::string& s)
   return s;
 }
 
-NuclideId parse_check_nid(std::string nucid)
+NuclideId parse_check_nid(std::string_view nucid)
 {
   auto ret = parse_nid(nucid);
   if (!check_nid_parse(nucid, ret))
@@ -310,10 +345,14 @@ NuclideId parse_check_nid(std::string nucid)
   return ret;
 }
 
-NuclideId parse_nid(std::string id)
+NuclideId parse_nid(std::string_view nucid)
 {
+  static const boost::regex nid_expr("^(?:\\s)*([0-9]+)([A-Z]+)(?:\\s)*$");
+  static const boost::regex dig_expr("^\\s*\\d+\\s*$");
+  static const boost::regex w_expr("^\\s*\\d+\\s*$");
+
+  std::string id(nucid);
   boost::to_upper(id);
-  boost::regex nid_expr("^(?:\\s)*([0-9]+)([A-Z]+)(?:\\s)*$");
   boost::smatch what;
   if (boost::regex_match(id, what, nid_expr) && (what.size() == 3))
   {
@@ -323,47 +362,47 @@ NuclideId parse_nid(std::string id)
 //    DBG << "Parsed big nucID " << id << " -> "
 //        << NuclideId::fromAZ(boost::lexical_cast<uint16_t>(A), Z).verboseName();
 
-    if (!is_number(A))
+    int a;
+    if (!parse_int(A, a))
     {
       DBG("<NuclideId> Bad A value from {}", id);
       return NuclideId();
     }
-    return NuclideId::fromAZ(std::stoi(A), Z);
+    return NuclideId::fromAZ(a, Z);
   }
 
   boost::trim(id);
-  boost::regex dig_expr("^\\s*\\d+\\s*$");
-  boost::regex w_expr("^\\s*\\d+\\s*$");
   if ((boost::regex_match(id, dig_expr)))
   {
     if (id.size() == 5)
     {
-      std::string A = id.substr(0,3);
-      std::string Z_str = id.substr(3,2);
-      uint16_t Z = 0;
-      if (!boost::trim_copy(Z_str).empty())
+      std::string_view A = std::string_view(id).substr(0,3);
+      std::string_view Z_str = std::string_view(id).substr(3,2);
+      int Z = 0;
+      if (!trim_view(Z_str).empty())
       {
-        std::string zstring = "1" + id.substr(3,2);
-        if (is_number(zstring))
-          Z = std::stoi(zstring);
-        else
+        std::string zstring = "1" + std::string(Z_str);
+        double number;
+        if (!parse_double(zstring, number) || !parse_int(zstring, Z))
           DBG("<NuclideId> Bad zstring from {}", id);
       }
-      if (!is_number(A))
+      int a;
+      if (!parse_int(A, a))
       {
         DBG("<NuclideId> Bad A value (2) from {}", id);
         return NuclideId();
       }
-      return NuclideId::fromAZ(std::stoi(A), Z);
+      return NuclideId::fromAZ(a, Z);
     }
     else
     {
-      if (!is_number(id))
+      int a;
+      if (!parse_int(id, a))
       {
         DBG("<NuclideId> Bad id value from {}", id);
         return NuclideId();
       }
-      return NuclideId::fromAZ(std::stoi(id), 0, true);
+      return NuclideId::fromAZ(a, 0, true);
     }
   }
   else if ((boost::regex_match(id, w_expr)))
@@ -510,9 +549,10 @@ spin_split(const std::string& data)
 }
 
 
-SpinSet parse_spins(std::string data)
+SpinSet parse_spins(std::string_view field)
 {
   SpinSet ret;
+  std::string data(trim_view(field));
   boost::to_upper(data);
   simplify_logic(data);
   boost::replace_all(data, " ", "");
@@ -594,10 +634,25 @@ SpinParity parse_spin_parity(std::string data)
   return ret;
 }
 
-HalfLife parse_halflife(std::string record_orig)
+HalfLife parse_halflife(std::string_view field)
 {
-  record_orig = boost::regex_replace(record_orig, boost::regex("[\\s]{2,}"), " ");
-  boost::trim(record_orig);
+  // trim, and collapse inner runs of whitespace into a single space
+  std::string record_orig;
+  field = trim_view(field);
+  for (size_t i = 0; i < field.size(); ++i)
+  {
+    if (std::isspace(static_cast<unsigned char>(field[i]))
+        && (i + 1 < field.size())
+        && std::isspace(static_cast<unsigned char>(field[i+1])))
+    {
+      while ((i + 1 < field.size())
+             && std::isspace(static_cast<unsigned char>(field[i+1])))
+        ++i;
+      record_orig += ' ';
+    }
+    else
+      record_orig += field[i];
+  }
 
   auto record = record_orig;
 
@@ -907,11 +962,11 @@ std::string nid_to_ensdf(NuclideId id, bool alt)
   return nucid;
 }
 
-bool check_nid_parse(const std::string& s, const NuclideId& n)
+bool check_nid_parse(std::string_view s, const NuclideId& n)
 {
   std::string s1 = boost::trim_copy(nid_to_ensdf(n, false));
   std::string s2 = boost::trim_copy(nid_to_ensdf(n, true));
-  std::string ss = boost::trim_copy(s);
+  std::string_view ss = trim_view(s);
   return (ss == s1) || (ss == s2);
 }
 
@@ -5,15 +5,22 @@
 #include <NucData/DecayInfo.h>
 #include <NucData/nid.h>
 #include <tuple>
+#include <string_view>
+
+// fixed-column slice of a record line, clamped to the line length
+std::string_view field(std::string_view line, size_t pos, size_t len);
+std::string_view trimmed_field(std::string_view line, size_t pos, size_t len);
+// trimmed copy of a fixed-column slice
+std::string field_str(std::string_view line, size_t pos, size_t len);
 
 bool is_uncertainty_id(const std::string& str);
 bool has_uncertainty_id(const std::string& str);
 std::string uncert_to_ensdf(Uncert::UncertaintyType t);
 Uncert::UncertaintyType parse_uncert_type(const std::string& str);
 std::string strip_uncert_type(const std::string& str);
-Uncert parse_val_uncert(std::string val, std::string uncert);
-Uncert parse_norm(std::string val, std::string uncert);
-Energy parse_energy(std::string val, std::string uncert);
+Uncert parse_val_uncert(std::string_view val, std::string_view uncert);
+Uncert parse_norm(std::string_view val, std::string_view uncert);
+Energy parse_energy(std::string_view val, std::string_view uncert);
 
 Uncert eval_mixing_ratio(Uncert vu, const std::string& mpol);
 
@@ -31,9 +38,9 @@ Parity parse_parity(const std::string& s);
 SpinParity parse_spin_parity(std::string data);
 void simplify_logic(std::string& s);
 std::pair<std::string, std::vector<std::string> > spin_split(const std::string& data);
-SpinSet parse_spins(std::string data);
+SpinSet parse_spins(std::string_view data);
 
-HalfLife parse_halflife(std::string record_orig);
+HalfLife parse_halflife(std::string_view record_orig);
 std::string hl_to_ensdf(HalfLife hl);
 DecayMode parse_decay_mode(std::string record);
 DecayInfo parse_decay_info(std::string dsid);
@@ -42,7 +49,7 @@ std::string mode_to_ensdf(DecayMode);
 
 std::string uncert_to_ensdf(Uncert);
 
-NuclideId parse_nid(std::string nucid);
-NuclideId parse_check_nid(std::string nucid);
+NuclideId parse_nid(std::string_view nucid);
+NuclideId parse_check_nid(std::string_view nucid);
 std::string nid_to_ensdf(NuclideId, bool alt);
-bool check_nid_parse(const std::string&, const NuclideId&);
+bool check_nid_parse(std::string_view, const NuclideId&);
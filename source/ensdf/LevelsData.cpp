@@ -11,7 +11,7 @@ LevelsData::LevelsData(ENSDFData& i)
   id = IdRecord(i);
   if (!id.valid())
   {
-    i.print("<LevelsData> Invalid ID", idx, id.debug());
+    REPORT_RECORD(i, "invalid", idx, id.debug());
     return;
   }
 
@@ -41,7 +41,7 @@ void LevelsData::read_comments(ENSDFData& i)
       if (com.valid())
         comments.push_back(com);
       else
-        i.print("<LevelsData> Invalid comment", idx, com.debug());
+        REPORT_RECORD(i, "invalid", idx, com.debug());
     }
     else
       break;
@@ -59,7 +59,7 @@ void LevelsData::read_hist(ENSDFData& i)
       if (his.valid())
         history.push_back(his);
       else
-        i.print("<LevelsData> Invalid history", idx, his.debug());
+        REPORT_RECORD(i, "invalid", idx, his.debug());
     }
     else
       break;
@@ -78,11 +78,11 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (pn.valid())
       {
         if (pnorm.valid())
-          i.print("<LevelsData> More than one loose pnorm", idx, pnorm.debug());
+          REPORT_RECORD(i, "more than one loose", idx, pnorm.debug());
         pnorm = pn;
       }
       else
-        i.print("<LevelsData> Invalid pnorm", idx, pn.debug());
+        REPORT_RECORD(i, "invalid", idx, pn.debug());
     }
     else if (QValueRecord::match(line))
     {
@@ -90,7 +90,7 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (qv.valid())
         qvals.push_back(qv);
       else
-        i.print("<LevelsData> Invalid qval", idx, qv.debug());
+        REPORT_RECORD(i, "invalid", idx, qv.debug());
     }
     else if (CommentsRecord::match(line, "."))
     {
@@ -98,7 +98,7 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (com.valid())
         comments.push_back(com);
       else
-        i.print("<LevelsData> Invalid comment", idx, com.debug());
+        REPORT_RECORD(i, "invalid", idx, com.debug());
     }
     else if (XRefRecord::match(line))
     {
@@ -106,7 +106,7 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (ref.valid())
         xrefs[ref.dsid] = ref.dssym;
       else
-        i.print("<LevelsData> Invalid xref", idx, ref.debug());
+        REPORT_RECORD(i, "invalid", idx, ref.debug());
     }
     else if (NormalizationRecord::match(line))
     {
@@ -114,12 +114,12 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (n.valid())
       {
         if (norm.size())
-          i.print("<LevelsData> Multiple norm", idx, n.debug());
+          REPORT_RECORD(i, "more than one", idx, n.debug());
 
         norm.push_back(n);
       }
       else
-        i.print("<LevelsData> Invalid norm", idx, n.debug());
+        REPORT_RECORD(i, "invalid", idx, n.debug());
     }
     else if (ParentRecord::match(line))
     {
@@ -127,7 +127,7 @@ void LevelsData::read_prelims(ENSDFData& i)
       if (par.valid())
         parents.push_back(par);
       else
-        i.print("<LevelsData> Invalid parent", idx, par.debug());
+        REPORT_RECORD(i, "invalid", idx, par.debug());
     }
     else
       break;
@@ -146,7 +146,7 @@ void LevelsData::read_unplaced(ENSDFData& i)
       if (a.valid())
         unplaced.alpha.push_back(a);
       else
-        i.print("<LevelsData> Invalid alpha", idx, a.debug());
+        REPORT_RECORD(i, "invalid", idx, a.debug());
     }
     else if (BetaRecord::match(line))
     {
@@ -154,7 +154,7 @@ void LevelsData::read_unplaced(ENSDFData& i)
       if (b.valid())
         unplaced.beta.push_back(b);
       else
-        i.print("<LevelsData> Invalid beta", idx, b.debug());
+        REPORT_RECORD(i, "invalid", idx, b.debug());
     }
     else if (GammaRecord::match(line))
     {
@@ -162,7 +162,7 @@ void LevelsData::read_unplaced(ENSDFData& i)
       if (g.valid())
         unplaced.gamma.push_back(g);
       else
-        i.print("<LevelsData> Invalid gamma", idx, g.debug());
+        REPORT_RECORD(i, "invalid", idx, g.debug());
     }
     else if (ParticleRecord::match(line))
     {
@@ -170,7 +170,7 @@ void LevelsData::read_unplaced(ENSDFData& i)
       if (p.valid())
         unplaced.particle.push_back(p);
       else
-        i.print("<LevelsData> Invalid particle", idx, p.debug());
+        REPORT_RECORD(i, "invalid", idx, p.debug());
     }
     else
       break;
@@ -188,11 +188,11 @@ void LevelsData::read_levels(ENSDFData& i)
       if (lev.valid())
         levels.push_back(lev);
       else
-        i.print("<LevelsData> Invalid level", idx, lev.debug());
+        REPORT_RECORD(i, "invalid", idx, lev.debug());
     }
     else
     {
-      i.print("<LevelsData> Bad record in levels block ", idx);
+      REPORT_RECORD(i, "unexpected in levels block", idx, "");
       ++i;
     }
   }
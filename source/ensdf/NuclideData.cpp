@@ -2,6 +2,7 @@
 #include <ensdf/Fields.h>
 
 #include <util/logger.h>
+#include <util/trace.h>
 #include "qpx_util.h"
 
 #include <boost/regex.hpp>
@@ -10,6 +11,7 @@ void NuclideData::merge_adopted(LevelsData &decaydata,
                                 double max_level_dif,
                                 double max_gamma_dif) const
 {
+  TRACE_SCOPE("NuclideData::merge_adopted");
   for (LevelRecord& lev : decaydata.levels)
   {
     for (auto ad : decays)
@@ -2,8 +2,6 @@
 
 #include <ensdf/LevelsData.h>
 
-#include <QList>
-
 struct NuclideData
 {
   std::list<HistoryRecord> history;
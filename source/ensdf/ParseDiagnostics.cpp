@@ -0,0 +1,93 @@
+#include <ensdf/ParseDiagnostics.h>
+#include <fmt/format.h>
+
+namespace
+{
+
+std::string escape_html(const std::string& text)
+{
+  std::string ret;
+  ret.reserve(text.size());
+  for (char c : text)
+    if (c == '<')
+      ret += "&lt;";
+    else if (c == '>')
+      ret += "&gt;";
+    else if (c == '&')
+      ret += "&amp;";
+    else
+      ret += c;
+  return ret;
+}
+
+}
+
+void ParseDiagnostics::report(const std::string& record_type,
+                              const std::string& reason,
+                              size_t line, const std::string& text)
+{
+  auto& issue = issues_[record_type][reason];
+  if (issue.count++ < max_samples)
+    issue.samples.push_back({line, text});
+}
+
+void ParseDiagnostics::add_time(const std::string& stage, double seconds)
+{
+  auto& s = stages_[stage];
+  s.count++;
+  s.seconds += seconds;
+}
+
+size_t ParseDiagnostics::issue_count() const
+{
+  size_t ret {0};
+  for (const auto& t : issues_)
+    for (const auto& r : t.second)
+      ret += r.second.count;
+  return ret;
+}
+
+nlohmann::json ParseDiagnostics::to_json() const
+{
+  nlohmann::json ret;
+  ret["issues"] = nlohmann::json::object();
+  for (const auto& t : issues_)
+  {
+    for (const auto& r : t.second)
+    {
+      nlohmann::json samples = nlohmann::json::array();
+      for (const auto& s : r.second.samples)
+        samples.push_back({{"line", s.line}, {"text", s.text}});
+      ret["issues"][t.first][r.first] = {{"count", r.second.count},
+                                         {"samples", samples}};
+    }
+  }
+  ret["stages"] = nlohmann::json::object();
+  for (const auto& s : stages_)
+    ret["stages"][s.first] = {{"count", s.second.count},
+                              {"seconds", s.second.seconds}};
+  return ret;
+}
+
+nlohmann::json ParseDiagnostics::to_html() const
+{
+  nlohmann::json ret = nlohmann::json::array();
+  for (const auto& t : issues_)
+  {
+    for (const auto& r : t.second)
+    {
+      std::string html = fmt::format("<b>{}, {}:</b> {}",
+                                     escape_html(t.first),
+                                     escape_html(r.first), r.second.count);
+      for (const auto& s : r.second.samples)
+        html += fmt::format("<br><tt>[{}] {}</tt>",
+                            s.line, escape_html(s.text));
+      ret.push_back(html);
+    }
+  }
+  for (const auto& s : stages_)
+    ret.push_back(fmt::format("<b>{}:</b> {:.1f} ms (x{})",
+                              s.first, 1000.0 * s.second.seconds,
+                              s.second.count));
+  return ret;
+}
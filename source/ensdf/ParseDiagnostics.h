@@ -0,0 +1,78 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// What a mass chain parse dropped or could not identify, and where it spent
+// its time. Issues are counted per record type and reason; only the first
+// few lines of each are kept, so reporting stays cheap on badly broken files.
+class ParseDiagnostics
+{
+public:
+  static constexpr size_t max_samples = 5;
+
+  struct Sample
+  {
+    size_t line {0};  // 1-based, as in the data file
+    std::string text;
+  };
+
+  struct Issue
+  {
+    size_t count {0};
+    std::vector<Sample> samples;
+  };
+
+  struct Stage
+  {
+    size_t count {0};
+    double seconds {0};
+  };
+
+  // record type -> reason -> issue
+  using Issues = std::map<std::string, std::map<std::string, Issue>>;
+
+  void report(const std::string& record_type, const std::string& reason,
+              size_t line, const std::string& text);
+  void add_time(const std::string& stage, double seconds);
+
+  const Issues& issues() const { return issues_; }
+  const std::map<std::string, Stage>& stages() const { return stages_; }
+  size_t issue_count() const;
+
+  nlohmann::json to_json() const;
+  // html paragraphs, for the scheme text pane
+  nlohmann::json to_html() const;
+
+private:
+  Issues issues_;
+  std::map<std::string, Stage> stages_;
+};
+
+// adds the lifetime of the scope to a stage; a null target disables it
+class StageTimer
+{
+public:
+  StageTimer(ParseDiagnostics* target, std::string stage)
+    : target_(target), stage_(std::move(stage))
+    , start_(std::chrono::steady_clock::now()) {}
+
+  ~StageTimer()
+  {
+    if (!target_)
+      return;
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start_;
+    target_->add_time(stage_, d.count());
+  }
+
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+  ParseDiagnostics* target_;
+  std::string stage_;
+  std::chrono::steady_clock::time_point start_;
+};
@@ -6,6 +6,7 @@
 #include <boost/regex.hpp>
 
 #include <util/logger.h>
+#include <util/trace.h>
 #include <ensdf/Translator.h>
 #include <fstream>
 #include <filesystem>
@@ -53,6 +54,7 @@ std::string ENSDFParser::directory() const
 
 DaughterParser ENSDFParser::get_dp(uint16_t a)
 {
+  TRACE_SCOPE("ENSDFParser::get_dp");
   if (!masses_.count(a))
     return DaughterParser();
   else if (!cache_.count(a))
@@ -64,23 +66,27 @@ DaughterParser ENSDFParser::get_dp(uint16_t a)
 
 DaughterParser::DaughterParser(uint16_t A, std::string directory)
 {
+  TRACE_SCOPE("DaughterParser::DaughterParser");
   std::string num = std::to_string(A);
   if (num.size() < 3)
     num = std::string(3-num.size(), '0') + num;
   std::string file = directory + "/ensdf." + num;
 
-  std::ifstream t(file);
-  std::string str;
+  std::vector<std::string> lines;
+  {
+    StageTimer timer(&diagnostics_, "read");
+    std::ifstream t(file);
+    std::string str;
 
-  t.seekg(0, std::ios::end);
-  str.reserve(t.tellg());
-  t.seekg(0, std::ios::beg);
+    t.seekg(0, std::ios::end);
+    str.reserve(t.tellg());
+    t.seekg(0, std::ios::beg);
 
-  str.assign((std::istreambuf_iterator<char>(t)),
-             std::istreambuf_iterator<char>());
+    str.assign((std::istreambuf_iterator<char>(t)),
+               std::istreambuf_iterator<char>());
 
-  std::vector<std::string> lines;
-  boost::split(lines, str, boost::is_any_of("\n"));
+    boost::split(lines, str, boost::is_any_of("\n"));
+  }
 
   parse(lines);
 }
@@ -338,6 +344,7 @@ DecayScheme DaughterParser::decay(NuclideId daughter,
                                   std::string decay_name, bool merge_adopted,
                                   double max_level_dif) const
 {
+  TRACE_SCOPE("DaughterParser::decay");
   if (!nuclide_data_.count(daughter) ||
       !nuclide_data_.at(daughter).decays.count(decay_name))
     return DecayScheme();
@@ -379,9 +386,16 @@ DecayScheme DaughterParser::mass_info() const
                   DecayInfo(), ReactionInfo());
 
   add_text(ret, mass_history_, mass_comments_);
+  if (!diagnostics_.issues().empty() || !diagnostics_.stages().empty())
+    ret.add_text("Parse diagnostics", diagnostics_.to_html());
   return ret;
 }
 
+const ParseDiagnostics& DaughterParser::diagnostics() const
+{
+  return diagnostics_;
+}
+
 
 std::list<BlockIndices> DaughterParser::find_blocks(const std::vector<std::string>& lines) const
 {
@@ -408,13 +422,15 @@ void DaughterParser::parse_comments_block(ENSDFData& i,
 {
   while (i.has_more())
   {
+    auto idx = i.i.first + 1;
     if (HistoryRecord::match(i.look_ahead()))
       hist.push_back(HistoryRecord(++i));
     else if (CommentsRecord::match(i.look_ahead(), "\\s"))
       comm.push_back(CommentsRecord(++i));
     else
     {
-      DBG("Unidentified record {}", i.read_pop());
+      ++i;
+      REPORT_RECORD(i, "unexpected in comments block", idx, "");
     }
   }
 }
@@ -423,17 +439,19 @@ void DaughterParser::parse_reference_block(ENSDFData &i)
 {
   while (i.has_more())
   {
+    auto idx = i.i.first + 1;
     if (ReferenceRecord::match(i.look_ahead()))
     {
       auto ref = ReferenceRecord(++i);
       if (ref.valid())
         references_[ref.keynum] = ref.reference;
       else
-        DBG("Invalid reference {}", ref.debug());
+        REPORT_RECORD(i, "invalid", idx, ref.debug());
     }
     else
     {
-      DBG("Unidentified record {}", i.read_pop());
+      ++i;
+      REPORT_RECORD(i, "unexpected in references block", idx, "");
     }
   }
 }
@@ -441,15 +459,22 @@ void DaughterParser::parse_reference_block(ENSDFData &i)
 
 void DaughterParser::parse(const std::vector<std::string>& lines)
 {
-  for (BlockIndices block_idx : find_blocks(lines))
+  std::list<BlockIndices> blocks;
+  {
+    StageTimer timer(&diagnostics_, "find blocks");
+    blocks = find_blocks(lines);
+  }
+
+  for (BlockIndices block_idx : blocks)
   {
-    ENSDFData data(lines, block_idx);
+    ENSDFData data(lines, block_idx, &diagnostics_);
 
     auto d2 = data;
     auto header = IdRecord(d2);
 
     if (test(header.type & RecordType::Comments))
     {
+      StageTimer timer(&diagnostics_, "comments");
       if (header.nuclide.composition_known())
         parse_comments_block(data,
                              nuclide_data_[header.nuclide].history,
@@ -462,19 +487,25 @@ void DaughterParser::parse(const std::vector<std::string>& lines)
     else if (test(header.type & RecordType::References) &&
              !header.nuclide.composition_known())
     {
+      StageTimer timer(&diagnostics_, "references");
       parse_reference_block(data);
     }
     else if (test(header.type & RecordType::AdoptedLevels))
+    {
+      StageTimer timer(&diagnostics_, "adopted levels");
       nuclide_data_[header.nuclide].add(LevelsData(data));
+    }
     else if (header.type != RecordType::Invalid)
     {
+      StageTimer timer(&diagnostics_, "datasets");
       //        auto name =
       nuclide_data_[header.nuclide].add(LevelsData(data));
       //        decay(decaydata.id.nuclide, name);
     }
     else
     {
-      DBG("ID type bad {}", header.extended_dsid);
+      REPORT_RECORD(data, "unknown dataset ID", block_idx.first,
+                    header.extended_dsid);
     }
   }
 }
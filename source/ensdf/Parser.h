@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ensdf/NuclideData.h>
+#include <set>
 
 class DaughterParser
 {
@@ -13,6 +14,9 @@ public:
 
   DecayScheme mass_info() const;
 
+  // dropped records and stage timing of the parse
+  const ParseDiagnostics& diagnostics() const;
+
   DecayScheme decay(NuclideId daughter,
                     std::string decay_name, bool merge_adopted,
                     double max_level_dif = 0.04) const;
@@ -22,6 +26,7 @@ private:
   std::list<CommentsRecord> mass_comments_;
   std::map<std::string, std::string> references_;
   std::map<NuclideId, NuclideData> nuclide_data_;
+  ParseDiagnostics diagnostics_;
 
   // block parsing
   std::list<BlockIndices> find_blocks(const std::vector<std::string> &lines) const;
@@ -63,7 +68,7 @@ public:
   bool good() const;
 
   [[nodiscard]]
-  inline QList<uint16_t> masses() const {return QList<uint16_t> {masses_.begin(), masses_.end()};}
+  inline const std::set<uint16_t>& masses() const {return masses_;}
 
   std::string directory() const;
 
@@ -5,6 +5,7 @@
 #include "qpx_util.h"
 
 #include <boost/regex.hpp>
+#include <unordered_map>
 
 #include <ensdf/records/Continuation.h>
 
@@ -14,7 +15,14 @@
 bool match_record_type(const std::string& line,
                        const std::string& pattern)
 {
-  return (line.size() == 80) && boost::regex_match(line, boost::regex(pattern));
+  if (line.size() != 80)
+    return false;
+  // record patterns come from a small fixed set, compile each once per thread
+  thread_local std::unordered_map<std::string, boost::regex> compiled;
+  auto it = compiled.find(pattern);
+  if (it == compiled.end())
+    it = compiled.emplace(pattern, boost::regex(pattern)).first;
+  return boost::regex_match(line, it->second);
 }
 
 bool match_first(const std::string& line,
@@ -33,6 +41,44 @@ bool match_cont(const std::string& line,
                            + sub_pattern + ".*$");
 }
 
+std::string record_type(const std::string& line)
+{
+  if (line.find_first_not_of(' ') == std::string::npos)
+    return "Blank";
+  auto column = [&line](size_t i) { return (i < line.size()) ? line[i] : ' '; };
+  char flag = column(6);
+  char type = column(7);
+  char particle = column(8);
+  if (std::string("cdtCDT").find(flag) != std::string::npos)
+    return "Comment";
+  if ((flag == 'P') && (type == 'N'))
+    return "Production normalization";
+  if (flag != ' ')
+    return "Unknown";
+  switch (type)
+  {
+    case 'A': return "Alpha";
+    case 'B': return "Beta";
+    case 'E': return "EC";
+    case 'G': return "Gamma";
+    case 'H': return "History";
+    case 'L': return "Level";
+    case 'N': return "Normalization";
+    case 'P': return "Parent";
+    case 'Q': return "Q-value";
+    case 'R': return "Reference";
+    case 'X': return "Cross-reference";
+    case ' ':
+    case 'D':
+      if ((particle == 'N') || (particle == 'P') || (particle == 'A'))
+        return (type == 'D') ? "Delayed particle" : "Particle";
+      if (type == ' ')
+        return "Identification";
+      break;
+  }
+  return "Unknown";
+}
+
 bool xref_check(const std::string& xref,
                 const std::string& dssym)
 {
@@ -63,9 +109,11 @@ bool xref_check(const std::string& xref,
 }
 
 
-ENSDFData::ENSDFData(const std::vector<std::string>& l, BlockIndices ii)
+ENSDFData::ENSDFData(const std::vector<std::string>& l, BlockIndices ii,
+                     ParseDiagnostics* diag)
   : i(ii)
   , lines(l)
+  , diagnostics(diag)
 {}
 
 bool ENSDFData::has_more() const
@@ -112,3 +160,16 @@ void ENSDFData::print(const std::string& prefix,
       (suffix.empty() ? " " : "\n"), suffix);
 }
 
+void ENSDFData::report(const std::string& reason, size_t idx)
+{
+  if (diagnostics && (idx < lines.size()))
+    diagnostics->report(record_type(idx), reason, idx + 1, lines[idx]);
+}
+
+std::string ENSDFData::record_type(size_t idx) const
+{
+  if (idx >= lines.size())
+    return "Unknown";
+  return ::record_type(lines[idx]);
+}
+
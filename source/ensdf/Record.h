@@ -1,6 +1,7 @@
 #pragma once
 
 #include <NucData/DecayScheme.h>
+#include <ensdf/ParseDiagnostics.h>
 #include <list>
 #include <cmath>
 
@@ -15,9 +16,11 @@ struct BlockIndices
 
 struct ENSDFData
 {
-  ENSDFData(const std::vector<std::string>& l, BlockIndices ii);
+  ENSDFData(const std::vector<std::string>& l, BlockIndices ii,
+            ParseDiagnostics* diag = nullptr);
   BlockIndices i;
   const std::vector<std::string>& lines;
+  ParseDiagnostics* diagnostics {nullptr};
 
   bool has_more() const;
   const std::string& look_ahead() const;
@@ -29,8 +32,26 @@ struct ENSDFData
 
   void print(const std::string& prefix, size_t idx,
              std::string suffix = "");
+  // counts line idx under its record type and reason, if diagnostics
+  // are being collected
+  void report(const std::string& reason, size_t idx);
+  std::string record_type(size_t idx) const;
 };
 
+// ENSDFData::report, then print with the suffix built only if debug
+// logging is on
+#define REPORT_RECORD(data, reason, idx, suffix) \
+  do { \
+    (data).report(reason, idx); \
+    if (DBG_ENABLED) \
+      (data).print("<" + (data).record_type(idx) + "> " + (reason), \
+                   idx, suffix); \
+  } while (0)
+
+// name of the record type in columns 7-9 of an ENSDF line,
+// as told apart by the match() of each record
+std::string record_type(const std::string& line);
+
 bool match_first(const std::string& line,
                  const std::string& sub_pattern);
 
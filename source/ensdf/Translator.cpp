@@ -6,46 +6,54 @@
 #include <algorithm>
 
 Translator::Translator()
-{
-  make_dictionary1();
-  make_dictionary2();
-  make_hist();
-}
+  : dict1(make_dictionary1())
+  , dict2(make_dictionary2())
+  , hist_keys_(make_hist_keys())
+  , hist_eval_types_(make_hist_eval_types())
+{}
 
-std::string Translator::hist_key(const std::string& s)
+std::string Translator::hist_key(const std::string& s) const
 {
   if (hist_keys_.count(s))
     return hist_keys_.at(s);
   return s;
 }
 
-std::string Translator::hist_eval_type(const std::string& s)
+std::string Translator::hist_eval_type(const std::string& s) const
 {
   if (hist_eval_types_.count(s))
     return hist_eval_types_.at(s);
   return s;
 }
 
-std::string Translator::translate1(const std::string &s)
+std::string Translator::translate1(const std::string &s) const
 {
+  static const std::string_view separators {" .,;:()-=+<>/$"};
+
   std::string ret;
-  // specify only the kept separators
-  boost::char_separator<char> sep("", " .,;:()-=+<>/$");
-  boost::tokenizer<boost::char_separator<char>> tokens(s, sep);
-  for (std::string t : tokens)
+  ret.reserve(s.size() + s.size() / 2);
+  std::string_view text(s);
+  // words and each separator on its own are looked up as whole tokens
+  size_t pos {0};
+  while (pos < text.size())
   {
-    for (auto r : dict1)
-      if (t == r.first)
-      {
-        t = r.second;
-        break;
-      }
-    ret += t;
+    size_t end = text.find_first_of(separators, pos);
+    if (end == pos)
+      end = pos + 1;
+    else if (end == std::string_view::npos)
+      end = text.size();
+    auto token = text.substr(pos, end - pos);
+    auto translated = dict1.find(token);
+    if (translated)
+      ret += *translated;
+    else
+      ret += token;
+    pos = end;
   }
   return ret;
 }
 
-void Translator::to_camel(std::string& s)
+void Translator::to_camel(std::string& s) const
 {
   boost::algorithm::to_lower(s);
   if (s.size())
@@ -53,7 +61,7 @@ void Translator::to_camel(std::string& s)
 }
 
 
-std::string Translator::auth_capitalize(const std::string& s)
+std::string Translator::auth_capitalize(const std::string& s) const
 {
   std::string ret;
   boost::char_separator<char> sep("", " .");
@@ -70,27 +78,22 @@ std::string Translator::auth_capitalize(const std::string& s)
   return ret;
 }
 
-void Translator::spaces_to_html(std::string &s)
+void Translator::spaces_to_html(std::string &s) const
 {
   boost::replace_all(s, "\n", "<br>");
   boost::replace_all(s, " ", "&nbsp;");
 }
 
-std::string Translator::spaces_to_html_copy(const std::string &s)
+std::string Translator::spaces_to_html_copy(const std::string &s) const
 {
   return boost::replace_all_copy(
         boost::replace_all_copy(s, "\n", "<br>"),
         " ", "&nbsp;");
 }
 
-std::string Translator::to_html(std::string s)
+std::string Translator::to_html(const std::string& original) const
 {
-  for (auto t : dict2_s)
-    boost::replace_all(s, t.first, t.second);
-
-  boost::replace_all(s, "<", "&lt;");
-  boost::replace_all(s, ">", "&gt;");
-  spaces_to_html(s);
+  std::string s = dict2.replace(original);
 //  DBG << "INPUT: " << s;
   std::string ret;
 
@@ -179,151 +182,164 @@ std::string Translator::to_html(std::string s)
   return ret;
 }
 
-void Translator::make_hist()
+std::map<std::string, std::string> Translator::make_hist_keys()
 {
-  hist_keys_["TYP"] = "Type";
-  hist_keys_["AUT"] = "Author(s)";
-  hist_keys_["DAT"] = "Date of change";
-  hist_keys_["CUT"] = "Literature cutoff date";
-  hist_keys_["CIT"] = "Citation";
-  hist_keys_["COM"] = "Comments";
-
-  hist_eval_types_["FUL"] = "Complete revision";
-  hist_eval_types_["FMT"] = "Format changes";
-  hist_eval_types_["ERR"] = "Errata";
-  hist_eval_types_["MOD"] = "Modified";
-  hist_eval_types_["UPD"] = "Update due to scan of new literature";
-  hist_eval_types_["EXP"] = "Experimental (not evaluated) data set";
+  std::map<std::string, std::string> ret;
+  ret["TYP"] = "Type";
+  ret["AUT"] = "Author(s)";
+  ret["DAT"] = "Date of change";
+  ret["CUT"] = "Literature cutoff date";
+  ret["CIT"] = "Citation";
+  ret["COM"] = "Comments";
+  return ret;
+}
 
+std::map<std::string, std::string> Translator::make_hist_eval_types()
+{
+  std::map<std::string, std::string> ret;
+  ret["FUL"] = "Complete revision";
+  ret["FMT"] = "Format changes";
+  ret["ERR"] = "Errata";
+  ret["MOD"] = "Modified";
+  ret["UPD"] = "Update due to scan of new literature";
+  ret["EXP"] = "Experimental (not evaluated) data set";
+  return ret;
 }
 
-void Translator::make_dictionary2()
+DictionaryTrie Translator::make_dictionary2()
 {
-  add_dict2('!', "&copy;", "!");
-  add_dict2('\"', "&macr;", "&quot;");
-  add_dict2('#', "&sect;", "&otimes;");
-  add_dict2('$', "e", "$");  //mathematical e?
-  add_dict2('%', "&radic;", "%");
-  add_dict2('&', "&equiv;", "&amp;");
-  add_dict2('\'', "&deg;", "&Aring;");
-  add_dict2('(', "&larr;", "(");
-  add_dict2(')', "&larr;", ")");
-  add_dict2('*', "&times;", "&sdot;");
-  add_dict2('+', "&plusmn;", "+");
-  add_dict2(',', "&frac12;", ",");
-  add_dict2('-', "&#8723;", "&minus;");
-  add_dict2('.', "&prop;", ".");
-  add_dict2('/', "&ne;", "/");
-  add_dict2('0', "(", "0");
-  add_dict2('1', ")", "1");
-  add_dict2('2', "[", "2");
-  add_dict2('3', "]", "3");
-  add_dict2('4', "&lt;", "4"); //should be dirac
-  add_dict2('5', "&gt;", "5"); //should be dirac
-  add_dict2('6', "&radic;", "6");
-  add_dict2('7', "&int;", "7");
-  add_dict2('8', "&prod;", "8");
-  add_dict2('9', "&sum;", "9");
-  add_dict2(':', "&dagger;", ":");
-  add_dict2(';', "&Dagger;", ";");
-  add_dict2('<', "&le;", "&lt;");
-  add_dict2('=', "&ne;", "=");
-  add_dict2('>', "&ge;", "&gt;");
-  add_dict2('?', "&asymp;", "?");
-  add_dict2('@', "&infin;", "&#9679;");
-  add_dict2('A', "&Alpha;", "&Auml;");
-  add_dict2('B', "&Beta;", "B");
-  add_dict2('C', "&Eta;", "C");
-  add_dict2('D', "&Delta;", "D");
-  add_dict2('E', "&Epsilon;", "&Eacute;");
-  add_dict2('F', "&Phi;", "F");
-  add_dict2('G', "&Gamma;", "G");
-  add_dict2('H', "&Chi;", "H");
-  add_dict2('I', "&Iota;", "I");
-  add_dict2('J', "∼", "J");
-  add_dict2('K', "&Kappa;", "K");
-  add_dict2('L', "&Lambda;", "L");
-  add_dict2('M', "&Mu;", "M");
-  add_dict2('N', "&Nu;", "N");
-  add_dict2('O', "&Omicron;", "&Ouml;");
-  add_dict2('P', "&Pi;", "P");
-  add_dict2('Q', "&Theta;", "&Otilde;");
-  add_dict2('R', "&Rho;", "R");
-  add_dict2('S', "&Sigma;", "S");
-  add_dict2('T', "&Tau;", "T");
-  add_dict2('U', "&upsih;", "&Uuml;");
-  add_dict2('V', "&nabla;", "V");
-  add_dict2('W', "&Omega;", "W");
-  add_dict2('X', "&Xi;", "X");
-  add_dict2('Y', "&Psi;", "Y");
-  add_dict2('Z', "&Zeta;", "Z");
-  add_dict2('[', "{", "[");
-  add_dict2(']', "}", "]");
-  add_dict2('^', "&uarr;", "^");
+  DictionaryTrie ret;
+  add_dict2(ret, '!', "&copy;", "!");
+  add_dict2(ret, '\"', "&macr;", "&quot;");
+  add_dict2(ret, '#', "&sect;", "&otimes;");
+  add_dict2(ret, '$', "e", "$");  //mathematical e?
+  add_dict2(ret, '%', "&radic;", "%");
+  add_dict2(ret, '&', "&equiv;", "&amp;");
+  add_dict2(ret, '\'', "&deg;", "&Aring;");
+  add_dict2(ret, '(', "&larr;", "(");
+  add_dict2(ret, ')', "&larr;", ")");
+  add_dict2(ret, '*', "&times;", "&sdot;");
+  add_dict2(ret, '+', "&plusmn;", "+");
+  add_dict2(ret, ',', "&frac12;", ",");
+  add_dict2(ret, '-', "&#8723;", "&minus;");
+  add_dict2(ret, '.', "&prop;", ".");
+  add_dict2(ret, '/', "&ne;", "/");
+  add_dict2(ret, '0', "(", "0");
+  add_dict2(ret, '1', ")", "1");
+  add_dict2(ret, '2', "[", "2");
+  add_dict2(ret, '3', "]", "3");
+  add_dict2(ret, '4', "&lt;", "4"); //should be dirac
+  add_dict2(ret, '5', "&gt;", "5"); //should be dirac
+  add_dict2(ret, '6', "&radic;", "6");
+  add_dict2(ret, '7', "&int;", "7");
+  add_dict2(ret, '8', "&prod;", "8");
+  add_dict2(ret, '9', "&sum;", "9");
+  add_dict2(ret, ':', "&dagger;", ":");
+  add_dict2(ret, ';', "&Dagger;", ";");
+  add_dict2(ret, '<', "&le;", "&lt;");
+  add_dict2(ret, '=', "&ne;", "=");
+  add_dict2(ret, '>', "&ge;", "&gt;");
+  add_dict2(ret, '?', "&asymp;", "?");
+  add_dict2(ret, '@', "&infin;", "&#9679;");
+  add_dict2(ret, 'A', "&Alpha;", "&Auml;");
+  add_dict2(ret, 'B', "&Beta;", "B");
+  add_dict2(ret, 'C', "&Eta;", "C");
+  add_dict2(ret, 'D', "&Delta;", "D");
+  add_dict2(ret, 'E', "&Epsilon;", "&Eacute;");
+  add_dict2(ret, 'F', "&Phi;", "F");
+  add_dict2(ret, 'G', "&Gamma;", "G");
+  add_dict2(ret, 'H', "&Chi;", "H");
+  add_dict2(ret, 'I', "&Iota;", "I");
+  add_dict2(ret, 'J', "∼", "J");
+  add_dict2(ret, 'K', "&Kappa;", "K");
+  add_dict2(ret, 'L', "&Lambda;", "L");
+  add_dict2(ret, 'M', "&Mu;", "M");
+  add_dict2(ret, 'N', "&Nu;", "N");
+  add_dict2(ret, 'O', "&Omicron;", "&Ouml;");
+  add_dict2(ret, 'P', "&Pi;", "P");
+  add_dict2(ret, 'Q', "&Theta;", "&Otilde;");
+  add_dict2(ret, 'R', "&Rho;", "R");
+  add_dict2(ret, 'S', "&Sigma;", "S");
+  add_dict2(ret, 'T', "&Tau;", "T");
+  add_dict2(ret, 'U', "&upsih;", "&Uuml;");
+  add_dict2(ret, 'V', "&nabla;", "V");
+  add_dict2(ret, 'W', "&Omega;", "W");
+  add_dict2(ret, 'X', "&Xi;", "X");
+  add_dict2(ret, 'Y', "&Psi;", "Y");
+  add_dict2(ret, 'Z', "&Zeta;", "Z");
+  add_dict2(ret, '[', "{", "[");
+  add_dict2(ret, ']', "}", "]");
+  add_dict2(ret, '^', "&uarr;", "^");
 
-  add_dict2('_', "&darr;", "_");
-  add_dict2('`', "&rsquo;", "&lsquo;");
+  add_dict2(ret, '_', "&darr;", "_");
+  add_dict2(ret, '`', "&rsquo;", "&lsquo;");
 
-  add_dict2('a', "&alpha;", "&auml;");
-  add_dict2('b', "&beta;", "b");
-  add_dict2('c', "&eta;", "c");
-  add_dict2('d', "&delta;", "d");
-  add_dict2('e', "&epsilon;", "&eacute;");
-  add_dict2('f', "&phi;", "f");
-  add_dict2('g', "&gamma;", "g");
-  add_dict2('h', "&chi;", "&#295;");
-  add_dict2('i', "&iota;", "i");
-  add_dict2('j', "&isin;", "j");
-  add_dict2('k', "&kappa;", "k");
-  add_dict2('l', "&lambda;", "&#411;");
-  add_dict2('m', "&mu;", "m");
-  add_dict2('n', "&nu;", "n");
-  add_dict2('o', "&omicron;", "&ouml;");
-  add_dict2('p', "&pi;", "p");
-  add_dict2('q', "&theta;", "&otilde;");
-  add_dict2('r', "&rho;", "r");
-  add_dict2('s', "&sigma;", "s");
-  add_dict2('t', "&tau;", "t");
-  add_dict2('u', "&upsilon;", "&uuml;");
-  add_dict2('v', "?", "v");
-  add_dict2('w', "&omega;", "w");
-  add_dict2('x', "&xi;", "x");
-  add_dict2('y', "&psi;", "y");
-  add_dict2('z', "&zeta;", "z");
+  add_dict2(ret, 'a', "&alpha;", "&auml;");
+  add_dict2(ret, 'b', "&beta;", "b");
+  add_dict2(ret, 'c', "&eta;", "c");
+  add_dict2(ret, 'd', "&delta;", "d");
+  add_dict2(ret, 'e', "&epsilon;", "&eacute;");
+  add_dict2(ret, 'f', "&phi;", "f");
+  add_dict2(ret, 'g', "&gamma;", "g");
+  add_dict2(ret, 'h', "&chi;", "&#295;");
+  add_dict2(ret, 'i', "&iota;", "i");
+  add_dict2(ret, 'j', "&isin;", "j");
+  add_dict2(ret, 'k', "&kappa;", "k");
+  add_dict2(ret, 'l', "&lambda;", "&#411;");
+  add_dict2(ret, 'm', "&mu;", "m");
+  add_dict2(ret, 'n', "&nu;", "n");
+  add_dict2(ret, 'o', "&omicron;", "&ouml;");
+  add_dict2(ret, 'p', "&pi;", "p");
+  add_dict2(ret, 'q', "&theta;", "&otilde;");
+  add_dict2(ret, 'r', "&rho;", "r");
+  add_dict2(ret, 's', "&sigma;", "s");
+  add_dict2(ret, 't', "&tau;", "t");
+  add_dict2(ret, 'u', "&upsilon;", "&uuml;");
+  add_dict2(ret, 'v', "?", "v");
+  add_dict2(ret, 'w', "&omega;", "w");
+  add_dict2(ret, 'x', "&xi;", "x");
+  add_dict2(ret, 'y', "&psi;", "y");
+  add_dict2(ret, 'z', "&zeta;", "z");
 
 
-  add_dict2('a', "&alpha;", "&ne;");
-  add_dict2('b', "&beta;", "&ne;");
-  add_dict2('g', "&gamma;", "&ne;");
-  add_dict2('d', "&delta;", "&ne;");
-  add_dict2('f', "&phi;", "&ne;");
-  add_dict2('l', "&lambda;", "&ne;");
-  add_dict2('m', "&mu;", "&ne;");
-  add_dict2('n', "&nu;", "&ne;");
-  add_dict2('p', "&pi;", "&ne;");
-  add_dict2('q', "&theta;", "&ne;");
-  add_dict2('s', "&sigma;", "&ne;");
+  add_dict2(ret, 'a', "&alpha;", "&ne;");
+  add_dict2(ret, 'b', "&beta;", "&ne;");
+  add_dict2(ret, 'g', "&gamma;", "&ne;");
+  add_dict2(ret, 'd', "&delta;", "&ne;");
+  add_dict2(ret, 'f', "&phi;", "&ne;");
+  add_dict2(ret, 'l', "&lambda;", "&ne;");
+  add_dict2(ret, 'm', "&mu;", "&ne;");
+  add_dict2(ret, 'n', "&nu;", "&ne;");
+  add_dict2(ret, 'p', "&pi;", "&ne;");
+  add_dict2(ret, 'q', "&theta;", "&ne;");
+  add_dict2(ret, 's', "&sigma;", "&ne;");
+
+  // escapes for whatever is left after control sequences
+  ret.insert("<", "&lt;");
+  ret.insert(">", "&gt;");
+  ret.insert("\n", "<br>");
+  ret.insert(" ", "&nbsp;");
+  return ret;
 }
 
-void Translator::add_dict2(char c, std::string alt1, std::string alt2)
+void Translator::add_dict2(DictionaryTrie& dict, char c,
+                           std::string alt1, std::string alt2)
 {
   if ((alt1.size() > 1) || (alt1[0] != c))
   {
     std::string s {"| "};
     s[1] = c;
-    dict2c1[c] = alt1;
-    dict2_s[s] = alt1;
+    dict.insert(s, alt1);
   }
   if ((alt2.size() > 1) || (alt2[0] != c))
   {
     std::string s {"~ "};
     s[1] = c;
-    dict2c2[c] = alt2;
-    dict2_s[s] = alt2;
+    dict.insert(s, alt2);
   }
 }
 
-void Translator::make_dictionary1()
+DictionaryTrie Translator::make_dictionary1()
 {
   std::map<std::string, std::string> map
   {
@@ -1345,10 +1361,8 @@ void Translator::make_dictionary1()
     {"|D","|D"}
   };
 
-  std::multimap<size_t, std::pair<std::string, std::string>> mmap;
-  for (auto l : map)
-    mmap.insert({l.first.size(), {l.first, l.second}});
-
-  for (auto l = mmap.rbegin(); l != mmap.rend(); ++l)
-    dict1.push_back(l->second);
+  DictionaryTrie ret;
+  for (const auto& l : map)
+    ret.insert(l.first, l.second);
+  return ret;
 }
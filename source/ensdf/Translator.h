@@ -2,49 +2,52 @@
 
 #include <string>
 #include <map>
-#include <list>
+#include <ensdf/DictionaryTrie.h>
 
+// Thread safety: all tables are built in the constructor and never modified
+// afterwards, and every member function is const. Initialization of the
+// singleton is serialized by the language (function-local static), so the
+// instance may be used from any number of threads without locking.
 class Translator
 {
 public:
- static Translator& instance()
+ static const Translator& instance()
  {
-   static Translator singleton_instance;
+   static const Translator singleton_instance;
    return singleton_instance;
  }
 
- std::string auth_capitalize(const std::string& s);
- void to_camel(std::string& s);
+ std::string auth_capitalize(const std::string& s) const;
+ void to_camel(std::string& s) const;
 
- std::string translate1(const std::string& s);
- std::string to_html(std::string s);
+ std::string translate1(const std::string& s) const;
+ std::string to_html(const std::string& s) const;
 
- void spaces_to_html(std::string& s);
- std::string spaces_to_html_copy(const std::string& s);
+ void spaces_to_html(std::string& s) const;
+ std::string spaces_to_html_copy(const std::string& s) const;
 
- std::string hist_key(const std::string& s);
- std::string hist_eval_type(const std::string& s);
+ std::string hist_key(const std::string& s) const;
+ std::string hist_eval_type(const std::string& s) const;
 
 private:
  //singleton assurance
  Translator();
- Translator(Translator const&);
- void operator=(Translator const&);
+ Translator(Translator const&) = delete;
+ void operator=(Translator const&) = delete;
 
- void make_dictionary1();
- void make_dictionary2();
- void make_hist();
+ static DictionaryTrie make_dictionary1();
+ static DictionaryTrie make_dictionary2();
+ static std::map<std::string, std::string> make_hist_keys();
+ static std::map<std::string, std::string> make_hist_eval_types();
 
- void add_dict2(char c, std::string alt1, std::string alt2);
+ static void add_dict2(DictionaryTrie& dict, char c,
+                       std::string alt1, std::string alt2);
 
- std::list<std::pair<std::string, std::string>> dict1;
-
- std::map<char, std::string> dict2c1;
- std::map<char, std::string> dict2c2;
- std::map<std::string, std::string> dict2_s;
-
- std::map<std::string, std::string> hist_keys_;
- std::map<std::string, std::string> hist_eval_types_;
+ // whole-token abbreviations
+ const DictionaryTrie dict1;
+ // control sequences and html escapes, applied in one pass
+ const DictionaryTrie dict2;
 
+ const std::map<std::string, std::string> hist_keys_;
+ const std::map<std::string, std::string> hist_eval_types_;
 };
-
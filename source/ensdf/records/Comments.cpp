@@ -20,8 +20,8 @@ CommentsRecord::CommentsRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_check_nid(line.substr(0, 5));
-  rtype = boost::trim_copy(line.substr(7, 1));
+  nuclide = parse_check_nid(field(line, 0, 5));
+  rtype = field_str(line, 7, 1);
 
 //  auto rrtype = rtype;
 //  boost::replace_all(rrtype, " ", "\\s");
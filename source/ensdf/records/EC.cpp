@@ -13,24 +13,24 @@ ECRecord::ECRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  energy = parse_energy(line.substr(9,10), line.substr(19,2));
-  intensity_beta_plus = parse_norm(line.substr(21,8), line.substr(29,2));
-  intensity_ec = parse_norm(line.substr(31,8), line.substr(39,2));
-  LOGFT = parse_norm(line.substr(41,8), line.substr(49,6));
-  intensity_total = parse_norm(line.substr(64,10), line.substr(74,2));
-  comment_flag = boost::trim_copy(line.substr(76,1));
-  uniquness = boost::trim_copy(line.substr(77,2));
-  quality = boost::trim_copy(line.substr(79,1));
+  nuclide = parse_nid(field(line, 0, 5));
+  energy = parse_energy(field(line, 9, 10), field(line, 19, 2));
+  intensity_beta_plus = parse_norm(field(line, 21, 8), field(line, 29, 2));
+  intensity_ec = parse_norm(field(line, 31, 8), field(line, 39, 2));
+  LOGFT = parse_norm(field(line, 41, 8), field(line, 49, 6));
+  intensity_total = parse_norm(field(line, 64, 10), field(line, 74, 2));
+  comment_flag = field_str(line, 76, 1);
+  uniquness = field_str(line, 77, 2);
+  quality = field_str(line, 79, 1);
 
   std::string continuation;
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (CommentsRecord::match(line2, "E"))
       comments.push_back(CommentsRecord(++i));
     else if (match_cont(line2, "\\sE"))
-      continuation += "$" + boost::trim_copy(i.read_pop().substr(9,71));
+      continuation.append("$").append(trimmed_field(i.read_pop(), 9, 71));
     else
       break;
   }
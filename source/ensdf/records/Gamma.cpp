@@ -14,28 +14,28 @@ GammaRecord::GammaRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  energy = parse_energy(line.substr(9,10), line.substr(19,2));
-  intensity_rel_photons = parse_norm(line.substr(21,8), line.substr(29,2));
-  multipolarity = boost::trim_copy(line.substr(31,10));
+  nuclide = parse_nid(field(line, 0, 5));
+  energy = parse_energy(field(line, 9, 10), field(line, 19, 2));
+  intensity_rel_photons = parse_norm(field(line, 21, 8), field(line, 29, 2));
+  multipolarity = field_str(line, 31, 10);
 
-  auto mixing = parse_val_uncert(line.substr(41,8), line.substr(49,6));
+  auto mixing = parse_val_uncert(field(line, 41, 8), field(line, 49, 6));
   mixing_ratio = eval_mixing_ratio(mixing, multipolarity);
 
-  conversion_coef = parse_norm(line.substr(55,7), line.substr(62,2));
-  intensity_total_transition = parse_norm(line.substr(64,9), line.substr(74,2));
-  comment_flag = boost::trim_copy(line.substr(76,1));
-  coincidence = boost::trim_copy(line.substr(77,1));
-  quality = boost::trim_copy(line.substr(79,1));
+  conversion_coef = parse_norm(field(line, 55, 7), field(line, 62, 2));
+  intensity_total_transition = parse_norm(field(line, 64, 9), field(line, 74, 2));
+  comment_flag = field_str(line, 76, 1);
+  coincidence = field_str(line, 77, 1);
+  quality = field_str(line, 79, 1);
 
   std::string continuation;
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (CommentsRecord::match(line2, "G"))
       comments.push_back(CommentsRecord(++i));
     else if (match_cont(line2, "\\sG"))
-      continuation += "$" + boost::trim_copy(i.read_pop().substr(9,71));
+      continuation.append("$").append(trimmed_field(i.read_pop(), 9, 71));
     else
       break;
   }
@@ -19,8 +19,8 @@ IdRecord::IdRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_check_nid(line.substr(0, 5));
-  extended_dsid = dsid = boost::trim_copy(line.substr(9, 30));
+  nuclide = parse_check_nid(field(line, 0, 5));
+  extended_dsid = dsid = field_str(line, 9, 30);
   dsref = line.substr(39, 15);
   pub = line.substr(65, 8);
   std::string year_str = line.substr(74, 4);
@@ -42,7 +42,7 @@ IdRecord::IdRecord(ENSDFData& i)
 
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (match_cont(line2, "\\s{2}"))
       extended_dsid += boost::trim_copy(i.read_pop().substr(9, 30));
     else if (CommentsRecord::match(line2))
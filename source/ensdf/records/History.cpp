@@ -15,7 +15,7 @@ HistoryRecord::HistoryRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_check_nid(line.substr(0, 5));
+  nuclide = parse_check_nid(field(line, 0, 5));
 
   std::string hdata = line.substr(9, 71);
   while (i.has_more() && match_cont(i.look_ahead(), "\\sH"))
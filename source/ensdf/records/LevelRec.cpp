@@ -20,39 +20,39 @@ LevelRecord::LevelRecord(ENSDFData& i)
 //  if (!match(line))
 //    return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  parse_energy_offset(line.substr(9,10), line.substr(19,2));
-  spins = parse_spins(line.substr(21, 18));
-  halflife = parse_halflife(line.substr(39, 16)); //not always true!!!!
-  L = boost::trim_copy(line.substr(55,9));
+  nuclide = parse_nid(field(line, 0, 5));
+  parse_energy_offset(field(line, 9, 10), field(line, 19, 2));
+  spins = parse_spins(field(line, 21, 18));
+  halflife = parse_halflife(field(line, 39, 16)); //not always true!!!!
+  L = field_str(line, 55, 9);
 
   try
   {
-    S = parse_norm(line.substr(64,10), line.substr(74,2));
+    S = parse_norm(field(line, 64, 10), field(line, 74, 2));
   }
   catch (...)
   {
-    auto sstr = line.substr(64, 12);
+    //      auto sstr = line.substr(64, 12);
     //      DBG << "<LevelRecord::parse> failed to parse Svalue=\'" << sstr << "\'";
   }
 
-  comment_flag = boost::trim_copy(line.substr(76,1));
+  comment_flag = field_str(line, 76, 1);
   if (line[77] == 'M')
   {
-    if (is_number(line.substr(78,1)))
-      isomeric = std::stoi(line.substr(78,1));
+    if (std::isdigit(static_cast<unsigned char>(line[78])))
+      isomeric = line[78] - '0';
     else
       isomeric = 1;
   }
 
-  quality = boost::trim_copy(line.substr(79,1));
+  quality = field_str(line, 79, 1);
 
   std::string continuation;
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (match_cont(line2, "\\sL"))
-      continuation += "$" + boost::trim_copy(i.read_pop().substr(9,71));
+      continuation.append("$").append(trimmed_field(i.read_pop(), 9, 71));
     else if (CommentsRecord::match(line2, "L"))
       comments.push_back(CommentsRecord(++i));
     else if (AlphaRecord::match(line2))
@@ -72,41 +72,46 @@ LevelRecord::LevelRecord(ENSDFData& i)
     continuations_ = parse_continuation(continuation);
 }
 
-void LevelRecord::parse_energy_offset(std::string val,
-                                      std::string uncert)
+void LevelRecord::parse_energy_offset(std::string_view value,
+                                      std::string_view uncert)
 {
-//  auto oval = val;
-  boost::replace_all(val, " ", "");
+  static const boost::regex re_number("^" RE_NUMBER "$");
+  static const boost::regex re_offset("^" RE_OFFSET "\\+?$");
+  static const boost::regex re_offsets("^" RE_OFFSET "\\+" RE_OFFSET "$");
+  static const boost::regex re_offset_number("^" RE_OFFSET RE_NUMBER "$");
+  static const boost::regex re_number_offset("^" RE_NUMBER "\\+" RE_OFFSET "$");
+
+  std::string val;
+  val.reserve(value.size());
+  for (char c : value)
+    if (c != ' ')
+      val.push_back(c);
 
   boost::smatch what1, what2, what3;
-  if (boost::regex_match(val, boost::regex("^" RE_NUMBER "$")))
+  if (boost::regex_match(val, re_number))
   {
 
   }
-  else if ((boost::regex_search(val, what1,
-                           boost::regex("^" RE_OFFSET "\\+?$")))
+  else if ((boost::regex_search(val, what1, re_offset))
     && (what1.size() == 2))
   {
     offsets.push_back(what1[1]);
     val = "0";
   }
-  else if ((boost::regex_search(val, what1,
-                           boost::regex("^" RE_OFFSET "\\+" RE_OFFSET "$")))
+  else if ((boost::regex_search(val, what1, re_offsets))
     && (what1.size() == 3))
   {
     offsets.push_back(what1[1]);
     offsets.push_back(what1[2]);
     val = "0";
   }
-  else if ((boost::regex_search(val, what2,
-                                boost::regex("^" RE_OFFSET RE_NUMBER "$")))
+  else if ((boost::regex_search(val, what2, re_offset_number))
     && (what2.size() == 3))
   {
     offsets.push_back(what2[1]);
     val = what2[2];
   }
-  else if ((boost::regex_search(val, what3,
-                                boost::regex("^" RE_NUMBER "\\+" RE_OFFSET "$")))
+  else if ((boost::regex_search(val, what3, re_number_offset))
     && (what3.size() == 3))
   {
     offsets.push_back(what3[2]);
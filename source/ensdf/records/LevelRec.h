@@ -49,8 +49,8 @@ struct LevelRecord
                                         double maxdif = kDoubleNaN) const;
 
 private:
-  void parse_energy_offset(std::string val,
-                           std::string uncert);
+  void parse_energy_offset(std::string_view value,
+                           std::string_view uncert);
 
   std::string offsets_to_str() const;
 };
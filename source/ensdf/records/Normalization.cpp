@@ -13,17 +13,17 @@ NormalizationRecord::NormalizationRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
+  nuclide = parse_nid(field(line, 0, 5));
 
-  NR = parse_norm(line.substr(9,10), line.substr(19,2));
-  NT = parse_norm(line.substr(21,8), line.substr(29,2));
-  BR = parse_norm(line.substr(31,8), line.substr(39,2));
-  NB = parse_norm(line.substr(41,8), line.substr(49,6));
-  NP = parse_norm(line.substr(55,7), line.substr(62,2));
+  NR = parse_norm(field(line, 9, 10), field(line, 19, 2));
+  NT = parse_norm(field(line, 21, 8), field(line, 29, 2));
+  BR = parse_norm(field(line, 31, 8), field(line, 39, 2));
+  NB = parse_norm(field(line, 41, 8), field(line, 49, 6));
+  NP = parse_norm(field(line, 55, 7), field(line, 62, 2));
 
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (CommentsRecord::match(line2, "N"))
       comments.push_back(CommentsRecord(++i));
     else if (ProdNormalizationRecord::match(line2))
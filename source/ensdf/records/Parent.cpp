@@ -12,11 +12,11 @@ ParentRecord::ParentRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  energy = parse_energy(line.substr(9,10), line.substr(19,2));
-  spins = parse_spins(line.substr(21, 18));
-  hl = parse_halflife(line.substr(39, 16));
-  QP = parse_energy(line.substr(64,10), line.substr(74,2));
+  nuclide = parse_nid(field(line, 0, 5));
+  energy = parse_energy(field(line, 9, 10), field(line, 19, 2));
+  spins = parse_spins(field(line, 21, 18));
+  hl = parse_halflife(field(line, 39, 16));
+  QP = parse_energy(field(line, 64, 10), field(line, 74, 2));
   ionization = line.substr(76,4);
 }
 
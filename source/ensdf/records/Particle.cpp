@@ -13,29 +13,29 @@ ParticleRecord::ParticleRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
+  nuclide = parse_nid(field(line, 0, 5));
   delayed = (line[7] == 'D');
   particle = line.substr(8,1);
 
-  energy = parse_energy(line.substr(9,10), line.substr(19,2));
-  intensity = parse_norm(line.substr(21,8), line.substr(29,2));
-  energy_intermediate = boost::trim_copy(line.substr(31,8));
-  transition_width = parse_norm(line.substr(39,10), line.substr(49,6));
-  L = boost::trim_copy(line.substr(55,9));
+  energy = parse_energy(field(line, 9, 10), field(line, 19, 2));
+  intensity = parse_norm(field(line, 21, 8), field(line, 29, 2));
+  energy_intermediate = field_str(line, 31, 8);
+  transition_width = parse_norm(field(line, 39, 10), field(line, 49, 6));
+  L = field_str(line, 55, 9);
 
-  comment_flag = boost::trim_copy(line.substr(76,1));
-  coincidence = boost::trim_copy(line.substr(77,1));
-  quality = boost::trim_copy(line.substr(79,1));
+  comment_flag = field_str(line, 76, 1);
+  coincidence = field_str(line, 77, 1);
+  quality = field_str(line, 79, 1);
 
   std::string continuation;
   std::string signature = line.substr(7,2);
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (CommentsRecord::match(line2, signature))
       comments.push_back(CommentsRecord(++i));
     else if (match_cont(line2, "\\s" + signature))
-      continuation += "$" + boost::trim_copy(i.read_pop().substr(9,71));
+      continuation.append("$").append(trimmed_field(i.read_pop(), 9, 71));
     else
       break;
   }
@@ -13,11 +13,11 @@ ProdNormalizationRecord::ProdNormalizationRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  NRBR = parse_norm(line.substr(9,10), line.substr(19,2));
-  NTBR = parse_norm(line.substr(21,8), line.substr(29,2));
-  NBBR = parse_norm(line.substr(41,8), line.substr(49,6));
-  NP = parse_norm(line.substr(55,7), line.substr(62,2));
+  nuclide = parse_nid(field(line, 0, 5));
+  NRBR = parse_norm(field(line, 9, 10), field(line, 19, 2));
+  NTBR = parse_norm(field(line, 21, 8), field(line, 29, 2));
+  NBBR = parse_norm(field(line, 41, 8), field(line, 49, 6));
+  NP = parse_norm(field(line, 55, 7), field(line, 62, 2));
   comment_placement = (line.substr(76,1) == "C");
   auto dopt = line.substr(77,1);
   if (is_number(dopt))
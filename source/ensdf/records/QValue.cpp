@@ -17,14 +17,14 @@ QValueRecord::QValueRecord(ENSDFData& i,
   if (!match(line))
     return;
 
-  nuclide = parse_check_nid(line.substr(0, 5));
+  nuclide = parse_check_nid(field(line, 0, 5));
 
-  Q = parse_val_uncert(line.substr(8, 9), line.substr(19, 2));
-  SN = parse_val_uncert(line.substr(21, 7), line.substr(29, 2));
-  SP = parse_val_uncert(line.substr(31, 7), line.substr(39, 2));
-  QA = parse_val_uncert(line.substr(41, 7), line.substr(49, 5));
+  Q = parse_val_uncert(field(line, 8, 9), field(line, 19, 2));
+  SN = parse_val_uncert(field(line, 21, 7), field(line, 29, 2));
+  SP = parse_val_uncert(field(line, 31, 7), field(line, 39, 2));
+  QA = parse_val_uncert(field(line, 41, 7), field(line, 49, 5));
 
-  ref = boost::trim_copy(line.substr(55, 24));
+  ref = field_str(line, 55, 24);
 
   if (!recurse)
       return;
@@ -32,7 +32,7 @@ QValueRecord::QValueRecord(ENSDFData& i,
   bool altcomment {false};
   while (i.has_more())
   {
-    auto line2 = i.look_ahead();
+    const auto& line2 = i.look_ahead();
     if (CommentsRecord::match(line2, "Q"))
     {
       auto cr = CommentsRecord(++i);
@@ -13,9 +13,9 @@ ReferenceRecord::ReferenceRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_nid(line.substr(0,5));
-  keynum = boost::trim_copy(line.substr(9,8));
-  reference = boost::trim_copy(line.substr(17,63));
+  nuclide = parse_nid(field(line, 0, 5));
+  keynum = field_str(line, 9, 8);
+  reference = field_str(line, 17, 63);
 }
 
 bool ReferenceRecord::valid() const
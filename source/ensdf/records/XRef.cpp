@@ -13,9 +13,9 @@ XRefRecord::XRefRecord(ENSDFData& i)
   if (!match(line))
     return;
 
-  nuclide = parse_check_nid(line.substr(0, 5));
+  nuclide = parse_check_nid(field(line, 0, 5));
   dssym = line.substr(8, 1);
-  dsid = boost::trim_copy(line.substr(9, 40));
+  dsid = field_str(line, 9, 40);
 }
 
 std::string XRefRecord::debug() const
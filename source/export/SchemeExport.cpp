@@ -0,0 +1,188 @@
+#include "SchemeExport.h"
+
+#include <fmt/format.h>
+#include <cmath>
+
+bool parse_export_format(const std::string& s, ExportFormat& format)
+{
+  if ((s == "jsonl") || (s == "json"))
+    format = ExportFormat::JsonLines;
+  else if (s == "csv")
+    format = ExportFormat::Csv;
+  else
+    return false;
+  return true;
+}
+
+json uncert_to_json(const Uncert& u)
+{
+  if (!u.defined())
+    return json();
+  json j;
+  j["value"] = u.value();
+  if (std::isfinite(u.lowerUncertainty()))
+    j["lower"] = u.lowerUncertainty();
+  if (std::isfinite(u.upperUncertainty()))
+    j["upper"] = u.upperUncertainty();
+  j["text"] = u.to_string(false);
+  return j;
+}
+
+json halflife_to_json(const HalfLife& hl)
+{
+  if (!hl.valid())
+    return json();
+  json j;
+  j["stable"] = hl.stable();
+  if (!hl.stable())
+    j["seconds"] = hl.seconds();
+  j["text"] = hl.to_string();
+  return j;
+}
+
+json level_to_json(const Level& level)
+{
+  json j;
+  j["energy"] = uncert_to_json(level.energy().value());
+  j["spins"] = level.spins().to_string();
+  j["halflife"] = halflife_to_json(level.halfLife());
+  if (level.isomerNum())
+    j["isomer"] = level.isomerNum();
+  j["feed_intensity"] = uncert_to_json(level.normalizedFeedIntensity());
+  return j;
+}
+
+json transition_to_json(const Transition& transition)
+{
+  json j;
+  j["energy"] = uncert_to_json(transition.energy().value());
+  j["from"] = double(transition.from());
+  j["to"] = double(transition.to());
+  j["intensity"] = uncert_to_json(transition.intensity());
+  j["multipolarity"] = transition.multipolarity();
+  j["delta"] = uncert_to_json(transition.delta());
+  return j;
+}
+
+json scheme_to_json(const DecayScheme& scheme)
+{
+  auto info = scheme.decay_info();
+  auto daughter = scheme.daughterNuclide();
+
+  json j;
+  j["name"] = scheme.name();
+  j["A"] = daughter.id().A();
+  j["daughter"] = daughter.id().symbolicName();
+  j["parent"] = info.parent.symbolicName();
+  j["mode"] = info.mode.to_string();
+  j["parent_halflife"] = halflife_to_json(info.hl);
+
+  j["levels"] = json::array();
+  for (const auto& l : daughter.levels())
+    j["levels"].push_back(level_to_json(l.second));
+
+  j["transitions"] = json::array();
+  for (const auto& t : daughter.transitions())
+    j["transitions"].push_back(transition_to_json(t.second));
+  return j;
+}
+
+void write_jsonl(const DecayScheme& scheme, std::string& out)
+{
+  out += scheme_to_json(scheme).dump();
+  out += '\n';
+}
+
+static void csv_number(double d, std::string& out)
+{
+  if (std::isfinite(d))
+    out += fmt::format("{}", d);
+  out += ',';
+}
+
+static void csv_uncert(const Uncert& u, std::string& out)
+{
+  if (!u.defined())
+  {
+    out += ",,,";
+    return;
+  }
+  csv_number(u.value(), out);
+  csv_number(u.lowerUncertainty(), out);
+  csv_number(u.upperUncertainty(), out);
+}
+
+static void csv_text(const std::string& s, std::string& out)
+{
+  if (s.find_first_of(",\"\n") == std::string::npos)
+    out += s;
+  else
+  {
+    out += '"';
+    for (char c : s)
+    {
+      if (c == '"')
+        out += '"';
+      out += c;
+    }
+    out += '"';
+  }
+  out += ',';
+}
+
+static void csv_end(std::string& out)
+{
+  out.back() = '\n';
+}
+
+std::string csv_header()
+{
+  return "dataset,A,daughter,parent,mode,parent_halflife_s,"
+         "kind,energy,energy_lower,energy_upper,from,to,"
+         "intensity,intensity_lower,intensity_upper,"
+         "multipolarity,spins,halflife_s,isomer\n";
+}
+
+void write_csv(const DecayScheme& scheme, std::string& out)
+{
+  auto info = scheme.decay_info();
+  auto daughter = scheme.daughterNuclide();
+
+  std::string prefix;
+  csv_text(scheme.name(), prefix);
+  prefix += std::to_string(daughter.id().A()) + ",";
+  csv_text(daughter.id().symbolicName(), prefix);
+  csv_text(info.parent.symbolicName(), prefix);
+  csv_text(info.mode.to_string(), prefix);
+  csv_number(info.hl.valid() ? info.hl.seconds() : kDoubleNaN, prefix);
+
+  for (const auto& l : daughter.levels())
+  {
+    const auto& level = l.second;
+    out += prefix;
+    out += "level,";
+    csv_uncert(level.energy().value(), out);
+    out += ",,";
+    csv_uncert(level.normalizedFeedIntensity(), out);
+    out += ',';
+    csv_text(level.spins().to_string(), out);
+    csv_number(level.halfLife().valid() ? level.halfLife().seconds()
+                                        : kDoubleNaN, out);
+    out += std::to_string(level.isomerNum()) + ",";
+    csv_end(out);
+  }
+
+  for (const auto& t : daughter.transitions())
+  {
+    const auto& transition = t.second;
+    out += prefix;
+    out += "transition,";
+    csv_uncert(transition.energy().value(), out);
+    csv_number(transition.from(), out);
+    csv_number(transition.to(), out);
+    csv_uncert(transition.intensity(), out);
+    csv_text(transition.multipolarity(), out);
+    out += ",,,";
+    csv_end(out);
+  }
+}
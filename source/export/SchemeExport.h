@@ -0,0 +1,31 @@
+#pragma once
+
+#include <NucData/DecayScheme.h>
+
+#include <string>
+
+// Flat, machine-readable renditions of a decay scheme.
+// Both writers append to a caller-owned buffer so that one mass chain can be
+// serialized off the output thread and written in a single call.
+
+enum class ExportFormat
+{
+  JsonLines,
+  Csv
+};
+
+bool parse_export_format(const std::string& s, ExportFormat& format);
+
+json uncert_to_json(const Uncert& u);
+json halflife_to_json(const HalfLife& hl);
+json level_to_json(const Level& level);
+json transition_to_json(const Transition& transition);
+json scheme_to_json(const DecayScheme& scheme);
+
+// one JSON object per line
+void write_jsonl(const DecayScheme& scheme, std::string& out);
+
+// one row per level and per transition, dataset columns repeated;
+// level rows carry the feeding intensity in the intensity columns
+std::string csv_header();
+void write_csv(const DecayScheme& scheme, std::string& out);
@@ -0,0 +1,332 @@
+#include "SchemeExport.h"
+
+#include <ensdf/Parser.h>
+#include <util/logger.h>
+#include <util/trace.h>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Exports every decay scheme of an ENSDF database.
+//
+// Mass chains are parsed by a pool of workers, each with its own
+// DaughterParser, and serialized into one buffer per chain. Buffers are
+// written strictly in order of A, and workers may run at most `window`
+// chains ahead of the writer, so memory stays bounded by a few chains no
+// matter how large the database is.
+
+static void print_usage()
+{
+  std::cerr <<
+      "usage: nuclei-export -d <ensdf dir> [options]\n"
+      "  -d, --data <dir>      directory holding ensdf.NNN files\n"
+      "  -o, --output <file>   output file (default: stdout)\n"
+      "  -f, --format <fmt>    jsonl (default) or csv\n"
+      "  -j, --jobs <n>        worker threads (default: all cores)\n"
+      "  -a, --mass <A>        export only this mass chain (repeatable)\n"
+      "  -m, --merge-adopted   merge adopted levels into each decay\n"
+      "  -D, --diagnostics <file>\n"
+      "                        write parse diagnostics, one JSON line per chain\n"
+      "  -T, --trace <file>    write a Chrome trace of the export\n"
+      "  -v, --verbose         log parser messages\n"
+      "  -h, --help            show this help\n";
+}
+
+struct ExportOptions
+{
+  std::string directory;
+  std::string output;
+  std::string diagnostics;
+  std::string trace;
+  ExportFormat format {ExportFormat::JsonLines};
+  unsigned jobs {0};
+  std::set<uint16_t> masses;
+  bool merge_adopted {false};
+  bool verbose {false};
+};
+
+static bool parse_options(int argc, char* argv[], ExportOptions& opts)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg(argv[i]);
+    auto value = [&](std::string& v) -> bool
+    {
+      if (++i >= argc)
+      {
+        std::cerr << "missing value for " << arg << "\n";
+        return false;
+      }
+      v = argv[i];
+      return true;
+    };
+
+    std::string v;
+    if ((arg == "-h") || (arg == "--help"))
+      return false;
+    else if ((arg == "-m") || (arg == "--merge-adopted"))
+      opts.merge_adopted = true;
+    else if ((arg == "-v") || (arg == "--verbose"))
+      opts.verbose = true;
+    else if ((arg == "-d") || (arg == "--data"))
+    {
+      if (!value(opts.directory))
+        return false;
+    }
+    else if ((arg == "-o") || (arg == "--output"))
+    {
+      if (!value(opts.output))
+        return false;
+    }
+    else if ((arg == "-D") || (arg == "--diagnostics"))
+    {
+      if (!value(opts.diagnostics))
+        return false;
+    }
+    else if ((arg == "-T") || (arg == "--trace"))
+    {
+      if (!value(opts.trace))
+        return false;
+    }
+    else if ((arg == "-f") || (arg == "--format"))
+    {
+      if (!value(v))
+        return false;
+      if (!parse_export_format(v, opts.format))
+      {
+        std::cerr << "unknown format " << v << "\n";
+        return false;
+      }
+    }
+    else if ((arg == "-j") || (arg == "--jobs"))
+    {
+      if (!value(v))
+        return false;
+      opts.jobs = unsigned(std::stoul(v));
+    }
+    else if ((arg == "-a") || (arg == "--mass"))
+    {
+      if (!value(v))
+        return false;
+      opts.masses.insert(uint16_t(std::stoul(v)));
+    }
+    else
+    {
+      std::cerr << "unknown argument " << arg << "\n";
+      return false;
+    }
+  }
+  return !opts.directory.empty();
+}
+
+struct ChainOutput
+{
+  std::string data;
+  std::string diagnostics;
+  size_t issues {0};
+};
+
+static ChainOutput export_chain(uint16_t A, const ExportOptions& opts)
+{
+  TRACE_SCOPE("export_chain");
+  ChainOutput ret;
+  // a chain that cannot be parsed at all still yields an (empty) output,
+  // so the writer does not wait for it forever
+  try
+  {
+    std::string& out = ret.data;
+    DaughterParser dp(A, opts.directory);
+    for (const auto& daughter : dp.daughters())
+    {
+      for (const auto& name : dp.decays(daughter))
+      {
+        try
+        {
+          auto scheme = dp.decay(daughter, name, opts.merge_adopted);
+          if (!scheme.valid())
+            continue;
+          TRACE_SCOPE("write scheme");
+          if (opts.format == ExportFormat::Csv)
+            write_csv(scheme, out);
+          else
+            write_jsonl(scheme, out);
+        }
+        catch (std::exception& e)
+        {
+          ERR("<nuclei-export> Failed to export {} from A={}: {}",
+              name, A, e.what());
+        }
+      }
+    }
+
+    ret.issues = dp.diagnostics().issue_count();
+    if (!opts.diagnostics.empty())
+    {
+      json j = dp.diagnostics().to_json();
+      j["A"] = A;
+      ret.diagnostics = j.dump() + "\n";
+    }
+  }
+  catch (std::exception& e)
+  {
+    ERR("<nuclei-export> Failed to export A={}: {}", A, e.what());
+    return ChainOutput();
+  }
+  return ret;
+}
+
+int main(int argc, char* argv[])
+{
+  ExportOptions opts;
+  try
+  {
+    if (!parse_options(argc, argv, opts))
+    {
+      print_usage();
+      return EXIT_FAILURE;
+    }
+  }
+  catch (std::exception&)
+  {
+    print_usage();
+    return EXIT_FAILURE;
+  }
+
+  // stdout may carry the data, keep the log on stderr
+  auto logger = spdlog::stderr_color_mt("nuclei_export");
+  logger->set_level(opts.verbose ? spdlog::level::info : spdlog::level::err);
+  spdlog::set_default_logger(logger);
+
+  ENSDFParser parser(opts.directory);
+  if (!parser.good())
+  {
+    ERR("<nuclei-export> No ENSDF files found in {}", opts.directory);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<uint16_t> masses;
+  for (auto a : parser.masses())
+    if (opts.masses.empty() || opts.masses.count(a))
+      masses.push_back(a);
+
+  std::ofstream file;
+  if (!opts.output.empty())
+  {
+    file.open(opts.output, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      ERR("<nuclei-export> Could not open {} for writing", opts.output);
+      return EXIT_FAILURE;
+    }
+  }
+  std::ostream& out = opts.output.empty() ? std::cout : file;
+
+  std::ofstream diagnostics;
+  if (!opts.diagnostics.empty())
+  {
+    diagnostics.open(opts.diagnostics, std::ios::out | std::ios::trunc);
+    if (!diagnostics.is_open())
+    {
+      ERR("<nuclei-export> Could not open {} for writing", opts.diagnostics);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (opts.format == ExportFormat::Csv)
+    out << csv_header();
+
+  unsigned jobs = opts.jobs ? opts.jobs : std::thread::hardware_concurrency();
+  jobs = std::max(1u, std::min<unsigned>(jobs, unsigned(masses.size())));
+  const size_t window = 2 * size_t(jobs);
+
+  if (!opts.trace.empty())
+  {
+    Trace::set_thread_name("writer");
+    Trace::start();
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::map<size_t, ChainOutput> done;
+  size_t next_write {0};
+  std::atomic<size_t> next_chain {0};
+
+  auto worker = [&]()
+  {
+    if (Trace::enabled())
+      Trace::set_thread_name("worker");
+    while (true)
+    {
+      size_t idx = next_chain++;
+      if (idx >= masses.size())
+        return;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return idx < next_write + window; });
+      }
+
+      ChainOutput chain = export_chain(masses[idx], opts);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      done[idx] = std::move(chain);
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned i = 0; i < jobs; ++i)
+    pool.emplace_back(worker);
+
+  while (next_write < masses.size())
+  {
+    ChainOutput chain;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() { return done.count(next_write) > 0; });
+      chain = std::move(done[next_write]);
+      done.erase(next_write);
+    }
+    {
+      TRACE_SCOPE("write chain");
+      out << chain.data;
+    }
+    if (diagnostics.is_open())
+      diagnostics << chain.diagnostics;
+    INFO("<nuclei-export> Exported A={}, {} records dropped",
+         masses[next_write], chain.issues);
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ++next_write;
+    }
+    cv.notify_all();
+  }
+
+  for (auto& t : pool)
+    t.join();
+
+  if (!opts.trace.empty())
+  {
+    Trace::stop();
+    if (!Trace::write(opts.trace))
+      ERR("<nuclei-export> Could not write trace to {}", opts.trace);
+  }
+
+  out.flush();
+  diagnostics.flush();
+  if (!out || (diagnostics.is_open() && !diagnostics))
+  {
+    ERR("<nuclei-export> Write failed");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
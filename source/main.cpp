@@ -4,6 +4,7 @@
 #include "ENSDFDataSource.h"
 
 #include <QCommandLineParser>
+#include <util/trace.h>
 
 int main(int argc, char *argv[])
 {
@@ -25,12 +26,23 @@ int main(int argc, char *argv[])
   QCommandLineOption dieOption(QStringList() << "d" << "die",
                                QApplication::translate("main", "Die right away (for testing)"));
   parser.addOption(dieOption);
+  QCommandLineOption traceOption(QStringList() << "t" << "trace",
+                                 QApplication::translate("main", "Write a Chrome trace of the session to <file>"),
+                                 QApplication::translate("main", "file"));
+  parser.addOption(traceOption);
   parser.process(application);
   bool die_now = parser.isSet(dieOption);
+  QString trace_file = parser.value(traceOption);
 
   if (parser.isSet("h") || die_now)
     return EXIT_SUCCESS;
 
+  if (!trace_file.isEmpty())
+  {
+    Trace::set_thread_name("gui");
+    Trace::start();
+  }
+
   int retcode = 0;
   {
     Nuclei w;
@@ -39,6 +51,12 @@ int main(int argc, char *argv[])
     retcode = application.exec();
   }
 
+  if (!trace_file.isEmpty())
+  {
+    Trace::stop();
+    Trace::write(trace_file.toStdString());
+  }
+
   if (retcode == 6000)
   {
     QProcess::startDetached(qApp->arguments()[0], qApp->arguments());
@@ -0,0 +1,264 @@
+#include "BatchRender.h"
+
+#include <SchemeEditor/SchemeGraphics.h>
+#include <SchemeEditor/SchemeRender.h>
+#include <SchemeEditor/SchemeStyle.h>
+
+#include <ensdf/Parser.h>
+#include <util/json_file.h>
+#include <util/logger.h>
+#include <util/trace.h>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cctype>
+#include <set>
+
+namespace
+{
+
+// bump when the drawing changes, so that earlier renders are redone
+const int layout_version = 1;
+
+QString data_file(const std::string& directory, uint16_t A)
+{
+  return QString::fromStdString(directory)
+      + QString("/ensdf.%1").arg(A, int(3), int(10), QChar('0'));
+}
+
+QString manifest_file(const QString& output, uint16_t A)
+{
+  return QDir(output).absoluteFilePath(
+        QString(".nuclei-render/%1.json").arg(A, int(3), int(10), QChar('0')));
+}
+
+// what went into a chain's pictures: its data, the style and the options
+std::string chain_key(uint16_t A, const RenderOptions& opts)
+{
+  QCryptographicHash h(QCryptographicHash::Sha1);
+
+  QFile f(data_file(opts.directory, A));
+  if (!f.open(QIODevice::ReadOnly) || !h.addData(&f))
+    return "";
+
+  const auto& vis = SchemeStyle::settings();
+  QString style = QString("%1|%2|%3|%4|%5|%6")
+      .arg(vis.font().toString())
+      .arg(vis.inactive_color().name(QColor::HexArgb))
+      .arg(vis.selected_color().name(QColor::HexArgb))
+      .arg(vis.implicated_color().name(QColor::HexArgb))
+      .arg(vis.hover_color().name(QColor::HexArgb))
+      .arg(vis.nuclide_color().name(QColor::HexArgb));
+  h.addData(style.toUtf8());
+
+  std::string options = std::to_string(layout_version)
+      + "|" + std::to_string(int(opts.format))
+      + "|" + std::to_string(opts.merge_adopted)
+      + "|" + std::to_string(opts.min_intensity);
+  for (const auto& s : opts.selectors)
+    if (s.matches(A))
+      options += "|" + s.to_string();
+  h.addData(options.data(), int(options.size()));
+
+  return h.result().toHex().toStdString();
+}
+
+bool up_to_date(const QString& manifest, const std::string& key,
+                const QString& output)
+{
+  if (key.empty() || !QFileInfo::exists(manifest))
+    return false;
+
+  try
+  {
+    auto j = from_json_file(manifest.toStdString());
+    if (j.value("key", std::string()) != key)
+      return false;
+    for (const auto& f : j.at("files"))
+      if (!QFileInfo::exists(QDir(output).absoluteFilePath(
+                               QString::fromStdString(f.get<std::string>()))))
+        return false;
+    return true;
+  }
+  catch (std::exception& e)
+  {
+    DBG("<nuclei-render> Ignoring manifest {}: {}",
+        manifest.toStdString(), e.what());
+    return false;
+  }
+}
+
+// 152_Sm_152Eu_B-_decay_13.537_y.svg
+std::string file_stem(uint16_t A, const NuclideId& daughter,
+                      const std::string& decay)
+{
+  std::string ret = std::to_string(A) + "_" + daughter.element() + "_";
+  bool gap = false;
+  for (char c : decay)
+  {
+    if (std::isalnum(static_cast<unsigned char>(c))
+        || (c == '+') || (c == '-') || (c == '.'))
+    {
+      if (gap && (ret.back() != '_'))
+        ret += '_';
+      ret += c;
+      gap = false;
+    }
+    else
+      gap = true;
+  }
+  return ret;
+}
+
+}
+
+bool RenderSelector::parse(const std::string& s, RenderSelector& sel)
+{
+  sel = RenderSelector();
+  if (boost::iequals(s, "all"))
+    return true;
+
+  std::vector<std::string> parts;
+  boost::split(parts, s, boost::is_any_of(":"));
+  if (parts.empty() || (parts.size() > 3))
+    return false;
+
+  try
+  {
+    size_t pos {0};
+    unsigned long a = std::stoul(parts[0], &pos);
+    if ((pos != parts[0].size()) || !a || (a > 999))
+      return false;
+    sel.A = uint16_t(a);
+  }
+  catch (std::exception&)
+  {
+    return false;
+  }
+
+  if (parts.size() > 1)
+    sel.daughter = parts[1];
+  if (parts.size() > 2)
+    sel.decay = parts[2];
+  return true;
+}
+
+std::string RenderSelector::to_string() const
+{
+  if (!A)
+    return "all";
+  std::string ret = std::to_string(A);
+  if (!daughter.empty() || !decay.empty())
+    ret += ":" + daughter;
+  if (!decay.empty())
+    ret += ":" + decay;
+  return ret;
+}
+
+bool RenderSelector::matches(uint16_t a) const
+{
+  return !A || (A == a);
+}
+
+bool RenderSelector::matches(const NuclideId& d, const std::string& name) const
+{
+  if (!matches(d.A()))
+    return false;
+  if (!daughter.empty()
+      && !boost::iequals(daughter, d.element())
+      && !boost::iequals(daughter, d.symbolicName()))
+    return false;
+  return decay.empty() || boost::icontains(name, decay);
+}
+
+bool parse_render_format(const std::string& s, RenderFormat& format)
+{
+  if (s == "svg")
+    format = RenderFormat::Svg;
+  else if (s == "pdf")
+    format = RenderFormat::Pdf;
+  else
+    return false;
+  return true;
+}
+
+ChainResult render_chain(uint16_t A, const RenderOptions& opts)
+{
+  TRACE_SCOPE("render_chain");
+  ChainResult ret;
+
+  QString manifest = manifest_file(opts.output, A);
+  std::string key = chain_key(A, opts);
+  if (!opts.force && up_to_date(manifest, key, opts.output))
+  {
+    auto j = from_json_file(manifest.toStdString());
+    ret.cached = j.at("files").size();
+    return ret;
+  }
+
+  const std::string extension
+      = (opts.format == RenderFormat::Pdf) ? ".pdf" : ".svg";
+
+  DaughterParser dp(A, opts.directory);
+  std::set<std::string> used;
+  json files = json::array();
+  for (const auto& daughter : dp.daughters())
+  {
+    for (const auto& name : dp.decays(daughter))
+    {
+      bool selected = false;
+      for (const auto& s : opts.selectors)
+        selected = selected || s.matches(daughter, name);
+      if (!selected)
+        continue;
+
+      std::string stem = file_stem(A, daughter, name);
+      std::string file = stem + extension;
+      for (int i = 2; used.count(file); ++i)
+        file = stem + "_" + std::to_string(i) + extension;
+      used.insert(file);
+
+      try
+      {
+        auto scheme = dp.decay(daughter, name, opts.merge_adopted);
+        if (!scheme.valid())
+          continue;
+
+        SchemeGraphics graphics(scheme, opts.min_intensity);
+        graphics.setStyle(SchemeStyle::settings());
+        graphics.levelPlot();
+
+        QString path = QDir(opts.output).absoluteFilePath(QString::fromStdString(file));
+        bool ok = (opts.format == RenderFormat::Pdf)
+            ? render_pdf(graphics, path)
+            : render_svg(graphics, path);
+        if (!ok)
+        {
+          ERR("<nuclei-render> Could not write {}", path.toStdString());
+          ret.failed++;
+          continue;
+        }
+        files.push_back(file);
+        ret.rendered++;
+      }
+      catch (std::exception& e)
+      {
+        ERR("<nuclei-render> Failed to render {} from A={}: {}",
+            name, A, e.what());
+        ret.failed++;
+      }
+    }
+  }
+
+  // a chain with failures is redone next time
+  if (!ret.failed && !key.empty()
+      && QDir(opts.output).mkpath(".nuclei-render"))
+    to_json_file({{"key", key}, {"files", files}}, manifest.toStdString());
+
+  return ret;
+}
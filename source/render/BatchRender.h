@@ -0,0 +1,59 @@
+#pragma once
+
+#include <NucData/nid.h>
+
+#include <QString>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Batch rendering of decay schemes, one mass chain at a time.
+//
+// Each chain remembers what it last rendered in a manifest under the
+// output directory. When the data file, the style and the options are
+// unchanged and the files are still there, the chain is not even parsed.
+
+// "all", or A[:daughter[:decay]]. The daughter matches its element symbol
+// or its full name (Sm, Sm-152); the decay matches any part of its name,
+// ignoring case.
+struct RenderSelector
+{
+  uint16_t A {0};  // 0 for every mass chain
+  std::string daughter;
+  std::string decay;
+
+  static bool parse(const std::string& s, RenderSelector& sel);
+  std::string to_string() const;
+
+  bool matches(uint16_t a) const;
+  bool matches(const NuclideId& daughter, const std::string& decay) const;
+};
+
+enum class RenderFormat
+{
+  Svg,
+  Pdf
+};
+
+bool parse_render_format(const std::string& s, RenderFormat& format);
+
+struct RenderOptions
+{
+  std::string directory;
+  QString output;
+  RenderFormat format {RenderFormat::Svg};
+  std::vector<RenderSelector> selectors;
+  bool merge_adopted {false};
+  double min_intensity {0};
+  bool force {false};
+};
+
+struct ChainResult
+{
+  size_t rendered {0};
+  size_t cached {0};
+  size_t failed {0};
+};
+
+ChainResult render_chain(uint16_t A, const RenderOptions& opts);
@@ -0,0 +1,235 @@
+#include "BatchRender.h"
+
+#include <ensdf/Parser.h>
+#include <util/logger.h>
+#include <util/trace.h>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QProcess>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Renders decay schemes to SVG or PDF without showing any window.
+//
+// Scenes are drawn with the same items and style as in the GUI, so Qt
+// objects must stay on the main thread. Parallelism comes from worker
+// processes instead: the mass chains are dealt out round-robin, each worker
+// gets its share through the hidden --worker option and renders it alone.
+
+static std::vector<uint16_t> parse_masses(const QString& list)
+{
+  std::vector<uint16_t> ret;
+  for (const auto& a : list.split(',', Qt::SkipEmptyParts))
+    ret.push_back(uint16_t(a.toUInt()));
+  return ret;
+}
+
+static bool render_masses(const std::vector<uint16_t>& masses,
+                          const RenderOptions& opts)
+{
+  ChainResult total;
+  for (auto a : masses)
+  {
+    auto r = render_chain(a, opts);
+    INFO("<nuclei-render> A={}: {} rendered, {} from cache, {} failed",
+         a, r.rendered, r.cached, r.failed);
+    total.rendered += r.rendered;
+    total.cached += r.cached;
+    total.failed += r.failed;
+  }
+  if (masses.size() > 1)
+    INFO("<nuclei-render> {} chains: {} rendered, {} from cache, {} failed",
+         masses.size(), total.rendered, total.cached, total.failed);
+  return !total.failed;
+}
+
+int main(int argc, char* argv[])
+{
+  // draw into memory, with no display needed
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QApplication application(argc, argv);
+  // same organization and name as the GUI, to share its preferences
+  QCoreApplication::setOrganizationName(QString::fromUtf8("ARL"));
+  QCoreApplication::setApplicationName("Nuclei");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+        "Renders decay schemes to SVG or PDF, with the style set in the GUI.\n"
+        "Selectors are \"all\" (default) or A[:daughter[:decay]], e.g. 152,\n"
+        "152:Sm or \"152:Sm:EC DECAY\"; the decay matches any part of its name.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("selectors", "decays to render", "[selector...]");
+  QCommandLineOption dataOption(QStringList() << "d" << "data",
+                                "Directory holding ensdf.NNN files.", "dir");
+  QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                  "Directory to write the schemes to.", "dir");
+  QCommandLineOption formatOption(QStringList() << "f" << "format",
+                                  "svg (default) or pdf.", "fmt", "svg");
+  QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                "Worker processes (default: all cores).", "n", "0");
+  QCommandLineOption mergeOption(QStringList() << "m" << "merge-adopted",
+                                 "Merge adopted levels into each decay.");
+  QCommandLineOption intensityOption(QStringList() << "i" << "min-intensity",
+                                     "Hide weaker gamma transitions.", "percent", "0");
+  QCommandLineOption forceOption(QStringList() << "force",
+                                 "Render again even if nothing changed.");
+  QCommandLineOption verboseOption(QStringList() << "v" << "verbose",
+                                   "Log progress and parser messages.");
+  QCommandLineOption traceOption(QStringList() << "T" << "trace",
+                                 "Write a Chrome trace of the run, workers to <file>.N.", "file");
+  QCommandLineOption workerOption(QStringList() << "worker",
+                                  "Render only these mass chains.", "A,A,...");
+  workerOption.setFlags(QCommandLineOption::HiddenFromHelp);
+  parser.addOptions({dataOption, outputOption, formatOption, jobsOption,
+                     mergeOption, intensityOption, forceOption, verboseOption,
+                     traceOption, workerOption});
+  parser.process(application);
+
+  // stdout is left alone, keep the log on stderr
+  auto logger = spdlog::stderr_color_mt("nuclei_render");
+  logger->set_level(parser.isSet(verboseOption) ? spdlog::level::info : spdlog::level::err);
+  spdlog::set_default_logger(logger);
+
+  RenderOptions opts;
+  opts.directory = parser.value(dataOption).toStdString();
+  opts.output = parser.value(outputOption);
+  opts.merge_adopted = parser.isSet(mergeOption);
+  opts.min_intensity = parser.value(intensityOption).toDouble();
+  opts.force = parser.isSet(forceOption);
+  if (opts.directory.empty() || opts.output.isEmpty()
+      || !parse_render_format(parser.value(formatOption).toStdString(), opts.format))
+    parser.showHelp(EXIT_FAILURE);
+
+  auto selectors = parser.positionalArguments();
+  if (selectors.isEmpty())
+    selectors << "all";
+  for (const auto& s : selectors)
+  {
+    RenderSelector sel;
+    if (!RenderSelector::parse(s.toStdString(), sel))
+    {
+      ERR("<nuclei-render> Bad selector {}", s.toStdString());
+      return EXIT_FAILURE;
+    }
+    opts.selectors.push_back(sel);
+  }
+
+  if (!QDir().mkpath(opts.output))
+  {
+    ERR("<nuclei-render> Could not create {}", opts.output.toStdString());
+    return EXIT_FAILURE;
+  }
+
+  QString trace_file = parser.value(traceOption);
+  if (!trace_file.isEmpty())
+    Trace::start();
+
+  bool ok {false};
+  if (parser.isSet(workerOption))
+    ok = render_masses(parse_masses(parser.value(workerOption)), opts);
+  else
+  {
+    ENSDFParser ensdf(opts.directory);
+    if (!ensdf.good())
+    {
+      ERR("<nuclei-render> No ENSDF files found in {}", opts.directory);
+      return EXIT_FAILURE;
+    }
+
+    std::vector<uint16_t> masses;
+    for (auto a : ensdf.masses())
+      for (const auto& s : opts.selectors)
+        if (s.matches(a))
+        {
+          masses.push_back(a);
+          break;
+        }
+
+    unsigned jobs = parser.value(jobsOption).toUInt();
+    if (!jobs)
+      jobs = std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min<unsigned>(jobs, unsigned(masses.size())));
+
+    if (jobs == 1)
+      ok = render_masses(masses, opts);
+    else
+    {
+      QStringList args;
+      args << "-d" << parser.value(dataOption)
+           << "-o" << opts.output
+           << "-f" << parser.value(formatOption)
+           << "-i" << parser.value(intensityOption);
+      if (opts.merge_adopted)
+        args << "-m";
+      if (opts.force)
+        args << "--force";
+      if (parser.isSet(verboseOption))
+        args << "-v";
+
+      std::vector<std::unique_ptr<QProcess>> workers;
+      for (unsigned w = 0; w < jobs; ++w)
+      {
+        QStringList share;
+        for (size_t i = w; i < masses.size(); i += jobs)
+          share << QString::number(masses[i]);
+
+        QStringList worker_args = args;
+        if (!trace_file.isEmpty())
+          worker_args << "-T" << QString("%1.%2").arg(trace_file).arg(w);
+        worker_args << "--worker" << share.join(',') << selectors;
+
+        workers.push_back(std::make_unique<QProcess>());
+        workers.back()->setProcessChannelMode(QProcess::ForwardedChannels);
+        workers.back()->start(QCoreApplication::applicationFilePath(),
+                              worker_args);
+        if (!workers.back()->waitForStarted(-1))
+          ERR("<nuclei-render> Could not start worker {}: {}", w,
+              workers.back()->errorString().toStdString());
+      }
+
+      ok = true;
+      for (size_t w = 0; w < workers.size(); ++w)
+      {
+        TRACE_SCOPE("wait for worker");
+        auto& p = workers[w];
+        // exit status and code stay at NormalExit and 0 if it never ran
+        if (p->error() == QProcess::FailedToStart)
+        {
+          ok = false;
+          continue;
+        }
+        if (!p->waitForFinished(-1) || (p->error() != QProcess::UnknownError))
+        {
+          ERR("<nuclei-render> Worker {} failed: {}", w,
+              p->errorString().toStdString());
+          ok = false;
+        }
+        else if ((p->exitStatus() != QProcess::NormalExit)
+                 || (p->exitCode() != EXIT_SUCCESS))
+        {
+          ERR("<nuclei-render> Worker {} exited with code {}", w,
+              p->exitCode());
+          ok = false;
+        }
+      }
+    }
+  }
+
+  if (!trace_file.isEmpty())
+  {
+    Trace::stop();
+    if (!Trace::write(trace_file.toStdString()))
+      ERR("<nuclei-render> Could not write trace to {}", trace_file.toStdString());
+  }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,126 @@
+#include <search/ActivationSearch.h>
+
+#include <algorithm>
+#include <cmath>
+
+ActivationSearch::ActivationSearch(const GammaIndex& index,
+                                   const NuclideTable& nuclides)
+  : index_(index)
+{
+  const size_t n = index_.dataset_count();
+  target_.assign(n, NuclideTable::none);
+  abundance_.assign(n, 0.0);
+  capture_.assign(n, kDoubleNaN);
+  halflife_.assign(n, kDoubleNaN);
+  stable_.assign(n, 0);
+  mass_.assign(n, 0);
+
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    const auto& d = index_.dataset(i);
+    halflife_[i] = d.parent_halflife;
+    if (!d.parent.composition_known() || !d.parent.N())
+      continue;
+
+    NuclideId target = NuclideId::fromZN(d.parent.Z(), d.parent.N() - 1);
+    uint32_t row = nuclides.find(target);
+    if (row == NuclideTable::none)
+      continue;
+
+    target_[i] = row;
+    abundance_[i] = nuclides.abundance(row);
+    capture_[i] = nuclides.capture(row);
+    stable_[i] = nuclides.stable(row);
+    mass_[i] = target.A();
+  }
+}
+
+std::vector<ActivationSearch::Match>
+ActivationSearch::search(const Query& query) const
+{
+  const size_t n = target_.size();
+  const bool hl_filter = (query.min_halflife > 0)
+      || std::isfinite(query.max_halflife);
+
+  // filter the joined columns first, lines are only looked at for survivors
+  std::vector<double> activity(n, kDoubleNaN);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (target_[i] == NuclideTable::none)
+      continue;
+    if (query.stable_target && !stable_[i])
+      continue;
+    if (abundance_[i] < query.min_abundance)
+      continue;
+    if ((query.min_capture > 0) && !(capture_[i] >= query.min_capture))
+      continue;
+
+    double hl = halflife_[i];
+    if (std::isinf(hl))
+      continue;
+    if (hl_filter &&
+        (std::isnan(hl) || (hl < query.min_halflife) || (hl > query.max_halflife)))
+      continue;
+
+    // unknown half-lives are taken as saturated
+    double saturation = std::isnan(hl) ? 1.0
+        : -std::expm1(-std::log(2.0) / hl * query.irradiation);
+    double a = abundance_[i] / 100.0 * capture_[i] * saturation / double(mass_[i]);
+    activity[i] = std::isfinite(a) ? a : 0.0;
+  }
+
+  std::vector<int32_t> slot(n, -1);
+  std::vector<Match> ret;
+  auto r = index_.range(query.min_energy, query.max_energy);
+  for (size_t i = r.first; i < r.second; ++i)
+  {
+    const auto& l = index_.line(i);
+    if (std::isnan(activity[l.dataset]))
+      continue;
+    if ((query.min_intensity > 0) && !(l.intensity >= query.min_intensity))
+      continue;
+
+    double intensity = std::isfinite(l.intensity) ? l.intensity : 0.0;
+    int32_t& s = slot[l.dataset];
+    if (s < 0)
+    {
+      s = int32_t(ret.size());
+      Match m;
+      m.dataset = l.dataset;
+      m.target = target_[l.dataset];
+      m.line = i;
+      m.activity = activity[l.dataset];
+      m.score = m.activity * intensity / 100.0;
+      ret.push_back(m);
+      continue;
+    }
+
+    auto& m = ret[size_t(s)];
+    const auto& best = index_.line(m.line);
+    if (intensity > (std::isfinite(best.intensity) ? best.intensity : 0.0))
+    {
+      m.line = i;
+      m.score = m.activity * intensity / 100.0;
+    }
+  }
+
+  auto better = [](const Match& a, const Match& b)
+  {
+    if (a.score != b.score)
+      return a.score > b.score;
+    if (a.activity != b.activity)
+      return a.activity > b.activity;
+    return a.dataset < b.dataset;
+  };
+
+  if (query.max_results && (ret.size() > query.max_results))
+  {
+    std::partial_sort(ret.begin(), ret.begin() + long(query.max_results),
+                      ret.end(), better);
+    ret.resize(query.max_results);
+  }
+  else
+    std::sort(ret.begin(), ret.end(), better);
+
+  return ret;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <search/GammaIndex.h>
+#include <search/NuclideTable.h>
+
+/**
+ * @brief Ranks decays of (n,gamma) products by their expected line rate.
+ *
+ * Each decay dataset is joined once with the N-1 neighbour of its parent,
+ * the capture target, and the joined columns are kept alongside the index.
+ * A query then only filters those columns and scans the lines of the
+ * requested energy window.
+ *
+ * Activity per gram and unit flux is taken as
+ * abundance * sigma * (1 - exp(-lambda t)) / A, with the target mass number
+ * standing in for the atomic weight of the element.
+ */
+class ActivationSearch
+{
+public:
+  struct Query
+  {
+    double min_energy {0};
+    double max_energy {kDoubleInf};
+    double min_intensity {0};  // of the line
+    double min_abundance {0};  // of the target, percent
+    double min_capture {0};    // barn
+    bool stable_target {true};
+    double irradiation {3600}; // seconds
+    double min_halflife {0};   // product
+    double max_halflife {kDoubleInf};
+    size_t max_results {200};
+  };
+
+  struct Match
+  {
+    uint32_t dataset {0};
+    uint32_t target {NuclideTable::none}; // row in the nuclide table
+    size_t line {0};                      // strongest qualifying line
+    double activity {0};                  // relative, 0 if unknown
+    double score {0};                     // activity times line intensity
+  };
+
+  ActivationSearch(const GammaIndex& index, const NuclideTable& nuclides);
+
+  std::vector<Match> search(const Query& query) const;
+
+private:
+  const GammaIndex& index_;
+
+  // per dataset
+  std::vector<uint32_t> target_;
+  std::vector<double> abundance_;
+  std::vector<double> capture_;
+  std::vector<double> halflife_;
+  std::vector<uint8_t> stable_;
+  std::vector<uint16_t> mass_;
+};
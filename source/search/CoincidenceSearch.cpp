@@ -0,0 +1,76 @@
+#include <search/CoincidenceSearch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+CoincidenceSearch::CoincidenceSearch(const GammaIndex& index)
+  : index_(index)
+{}
+
+std::vector<CoincidenceSearch::Match>
+CoincidenceSearch::search(const Query& query) const
+{
+  GammaIndex::Query q;
+  q.tolerance = query.tolerance;
+  q.min_intensity = query.min_intensity;
+  q.min_halflife = query.min_halflife;
+  q.max_halflife = query.max_halflife;
+
+  q.energy = query.energy1;
+  auto hits1 = index_.find(q);
+  q.energy = query.energy2;
+  auto hits2 = index_.find(q);
+
+  // second lines grouped by dataset, so each first line meets only its peers
+  std::vector<std::pair<uint32_t, size_t>> by_dataset;
+  by_dataset.reserve(hits2.size());
+  for (auto h : hits2)
+    by_dataset.push_back({index_.line(h).dataset, h});
+  std::sort(by_dataset.begin(), by_dataset.end());
+
+  auto strength = [&](size_t a, size_t b)
+  {
+    double ia = index_.line(a).intensity;
+    double ib = index_.line(b).intensity;
+    return (std::isfinite(ia) ? ia : 0.0) * (std::isfinite(ib) ? ib : 0.0);
+  };
+
+  std::map<uint32_t, Match> best;
+  for (auto a : hits1)
+  {
+    const auto& la = index_.line(a);
+    auto range = std::equal_range(by_dataset.begin(), by_dataset.end(),
+                                  std::make_pair(la.dataset, size_t(0)),
+                                  [](const std::pair<uint32_t, size_t>& x,
+                                     const std::pair<uint32_t, size_t>& y)
+                                  { return x.first < y.first; });
+    if (range.first == range.second)
+      continue;
+
+    const auto& cascade = index_.cascade(la.dataset);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      size_t b = it->second;
+      const auto& lb = index_.line(b);
+      if (lb.transition == la.transition)
+        continue;
+      if (!cascade.coincident(la.transition, lb.transition,
+                              query.max_level_halflife))
+        continue;
+
+      auto found = best.find(la.dataset);
+      if ((found == best.end()) ||
+          (strength(a, b) > strength(found->second.line1, found->second.line2)))
+        best[la.dataset] = Match {la.dataset, a, b};
+    }
+  }
+
+  std::vector<Match> ret;
+  for (const auto& m : best)
+    ret.push_back(m.second);
+  std::stable_sort(ret.begin(), ret.end(),
+                   [&](const Match& x, const Match& y)
+                   { return strength(x.line1, x.line2) > strength(y.line1, y.line2); });
+  return ret;
+}
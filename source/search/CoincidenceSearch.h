@@ -0,0 +1,41 @@
+#pragma once
+
+#include <search/GammaIndex.h>
+
+/**
+ * @brief Finds decays in which two gamma lines are emitted in coincidence.
+ *
+ * Candidate pairs come from two energy ranges of the GammaIndex and are
+ * checked against the precomputed cascade closure of their dataset. An
+ * optional half-life limit restricts the cascade to intermediate levels
+ * that decay promptly enough to be seen within a coincidence window.
+ */
+class CoincidenceSearch
+{
+public:
+  struct Query
+  {
+    double energy1 {0};
+    double energy2 {0};
+    double tolerance {0.5};
+    double min_intensity {0};              // for both lines
+    double max_level_halflife {kDoubleInf}; // seconds
+    double min_halflife {0};               // parent
+    double max_halflife {kDoubleInf};      // parent
+  };
+
+  struct Match
+  {
+    uint32_t dataset {0};
+    size_t line1 {0};
+    size_t line2 {0};
+  };
+
+  explicit CoincidenceSearch(const GammaIndex& index);
+
+  // one match per dataset, the strongest qualifying pair
+  std::vector<Match> search(const Query& query) const;
+
+private:
+  const GammaIndex& index_;
+};
@@ -0,0 +1,126 @@
+#include <search/FingerprintSearch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+FingerprintSearch::FingerprintSearch(const GammaIndex& index)
+  : index_(index)
+{}
+
+std::vector<FingerprintSearch::Match>
+FingerprintSearch::search(const Query& query) const
+{
+  const size_t n = query.peaks.size();
+  const bool hl_filter = (query.min_halflife > 0)
+      || std::isfinite(query.max_halflife);
+
+  // candidates are only allocated for decays hit by at least one peak
+  std::vector<int32_t> slot(index_.dataset_count(), -1);
+  std::vector<Match> candidates;
+  std::vector<double> best;
+  std::vector<int32_t> touched;
+
+  for (size_t p = 0; p < n; ++p)
+  {
+    const auto& peak = query.peaks[p];
+    auto r = index_.range(peak.energy - peak.tolerance,
+                          peak.energy + peak.tolerance);
+    touched.clear();
+    for (size_t i = r.first; i < r.second; ++i)
+    {
+      const auto& l = index_.line(i);
+      int32_t& s = slot[l.dataset];
+      if (s < 0)
+      {
+        if (hl_filter)
+        {
+          double hl = index_.dataset(l.dataset).parent_halflife;
+          if (std::isnan(hl) ||
+              (hl < query.min_halflife) || (hl > query.max_halflife))
+            continue;
+        }
+        s = int32_t(candidates.size());
+        Match m;
+        m.dataset = l.dataset;
+        m.peaks.resize(n);
+        candidates.push_back(std::move(m));
+        best.push_back(0);
+      }
+
+      auto& m = candidates[size_t(s)];
+      if (!m.peaks.test(p))
+      {
+        m.peaks.set(p);
+        best[size_t(s)] = 0;
+        touched.push_back(s);
+      }
+      if (std::isfinite(l.intensity))
+        best[size_t(s)] = std::max(best[size_t(s)], l.intensity);
+    }
+
+    // a peak counts once per decay, with the strongest line in its window
+    for (auto s : touched)
+      candidates[size_t(s)].weight += best[size_t(s)];
+  }
+
+  std::vector<Match> ret;
+  for (auto& m : candidates)
+  {
+    size_t matched = m.peaks.count();
+    if (matched < std::max<size_t>(query.min_matched, 1))
+      continue;
+    double total = index_.total_intensity(m.dataset);
+    m.coverage = (total > 0) ? std::min(1.0, m.weight / total) : 0.0;
+    m.score = double(matched) + m.coverage;
+    ret.push_back(std::move(m));
+  }
+
+  auto better = [](const Match& a, const Match& b)
+  {
+    if (a.score != b.score)
+      return a.score > b.score;
+    if (a.weight != b.weight)
+      return a.weight > b.weight;
+    return a.dataset < b.dataset;
+  };
+
+  if (query.max_results && (ret.size() > query.max_results))
+  {
+    std::partial_sort(ret.begin(), ret.begin() + long(query.max_results),
+                      ret.end(), better);
+    ret.resize(query.max_results);
+  }
+  else
+    std::sort(ret.begin(), ret.end(), better);
+
+  return ret;
+}
+
+std::vector<FingerprintSearch::Peak>
+FingerprintSearch::parse_peaks(const std::string& text,
+                               double default_tolerance)
+{
+  std::vector<Peak> ret;
+  std::string entry;
+  std::istringstream entries(text);
+  while (std::getline(entries, entry))
+  {
+    std::replace(entry.begin(), entry.end(), ';', ',');
+    std::istringstream items(entry);
+    std::string item;
+    while (std::getline(items, item, ','))
+    {
+      std::istringstream values(item);
+      Peak p;
+      p.tolerance = default_tolerance;
+      if (!(values >> p.energy))
+        continue;
+      double tolerance;
+      if (values >> tolerance)
+        p.tolerance = std::abs(tolerance);
+      ret.push_back(p);
+    }
+  }
+  return ret;
+}
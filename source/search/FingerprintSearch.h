@@ -0,0 +1,54 @@
+#pragma once
+
+#include <search/GammaIndex.h>
+
+#include <boost/dynamic_bitset.hpp>
+
+/**
+ * @brief Ranks decays by how well they explain a set of observed peaks.
+ *
+ * Each peak is looked up in the energy-sorted GammaIndex. Every decay that
+ * has a line inside a peak window gets that peak's bit set, and the
+ * intensity of its strongest line there is added to the decay's weight.
+ * Decays are ranked by the number of peaks explained. Ties are broken by
+ * coverage, the fraction of the decay's total gamma intensity that the
+ * peaks account for.
+ */
+class FingerprintSearch
+{
+public:
+  struct Peak
+  {
+    double energy {0};
+    double tolerance {0.5};
+  };
+
+  struct Query
+  {
+    std::vector<Peak> peaks;
+    size_t min_matched {1};
+    double min_halflife {0};
+    double max_halflife {kDoubleInf};
+    size_t max_results {200};
+  };
+
+  struct Match
+  {
+    uint32_t dataset {0};
+    boost::dynamic_bitset<> peaks;  // which of the query peaks are explained
+    double weight {0};              // summed intensity of the matching lines
+    double coverage {0};            // weight / total intensity of the decay
+    double score {0};
+  };
+
+  explicit FingerprintSearch(const GammaIndex& index);
+
+  std::vector<Match> search(const Query& query) const;
+
+  // parses "energy [tolerance]" per line, ',' or ';' separated entries too
+  static std::vector<Peak> parse_peaks(const std::string& text,
+                                       double default_tolerance);
+
+private:
+  const GammaIndex& index_;
+};
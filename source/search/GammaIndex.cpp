@@ -0,0 +1,346 @@
+#include <search/GammaIndex.h>
+#include <ensdf/Parser.h>
+
+#include <util/logger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+static constexpr uint32_t kGammaIndexMagic = 0x4e474958;
+static constexpr uint32_t kGammaIndexVersion = 3;
+
+// smallest a dataset can take on disk: empty strings and cascade tables
+static constexpr uint64_t kMinDatasetBytes = sizeof(uint16_t) + 2 * 5
+    + 2 * sizeof(double) + 2 * sizeof(uint32_t) + 6 * sizeof(uint32_t);
+static constexpr uint64_t kLineBytes = 2 * sizeof(double) + 2 * sizeof(uint32_t);
+
+void GammaIndex::clear()
+{
+  datasets_.clear();
+  cascades_.clear();
+  lines_.clear();
+  totals_.clear();
+}
+
+bool GammaIndex::empty() const
+{
+  return lines_.empty();
+}
+
+size_t GammaIndex::size() const
+{
+  return lines_.size();
+}
+
+void GammaIndex::add_chain(uint16_t A, const DaughterParser& dp)
+{
+  for (const auto& daughter : dp.daughters())
+  {
+    for (const auto& name : dp.decays(daughter))
+    {
+      DecayScheme scheme;
+      try
+      {
+        scheme = dp.decay(daughter, name, false);
+      }
+      catch (std::exception& e)
+      {
+        ERR("<GammaIndex> Could not index {}: {}", name, e.what());
+        continue;
+      }
+
+      auto transitions = scheme.daughterNuclide().transitions();
+      if (transitions.empty())
+        continue;
+
+      auto info = scheme.decay_info();
+      Dataset d;
+      d.A = A;
+      d.daughter = daughter;
+      d.parent = info.parent;
+      d.parent_halflife = info.hl.valid() ? info.hl.seconds() : kDoubleNaN;
+      auto levels = scheme.daughterNuclide().levels();
+      if (!levels.empty())
+      {
+        const auto& ground = levels.begin()->second.halfLife();
+        if (ground.stable())
+          d.daughter_halflife = kDoubleInf;
+        else if (ground.valid())
+          d.daughter_halflife = ground.seconds();
+      }
+      d.name = name;
+      d.mode = info.mode.to_string();
+
+      uint32_t idx = uint32_t(datasets_.size());
+      datasets_.push_back(d);
+      cascades_.push_back(CascadeClosure(scheme.daughterNuclide()));
+      uint32_t local {0};
+      for (const auto& t : transitions)
+      {
+        Uncert intensity = t.second.intensity();
+        lines_.push_back({double(t.first),
+                          intensity.hasFiniteValue() ? intensity.value()
+                                                     : kDoubleNaN,
+                          idx, local++});
+      }
+    }
+  }
+}
+
+void GammaIndex::remove_chains(const std::set<uint16_t>& masses)
+{
+  if (masses.empty())
+    return;
+
+  // compact the dataset table and renumber the surviving lines
+  std::vector<uint32_t> remap(datasets_.size(), UINT32_MAX);
+  std::vector<Dataset> kept;
+  std::vector<CascadeClosure> kept_cascades;
+  for (size_t i = 0; i < datasets_.size(); ++i)
+    if (!masses.count(datasets_[i].A))
+    {
+      remap[i] = uint32_t(kept.size());
+      kept.push_back(std::move(datasets_[i]));
+      kept_cascades.push_back(std::move(cascades_[i]));
+    }
+  datasets_ = std::move(kept);
+  cascades_ = std::move(kept_cascades);
+
+  std::vector<Line> lines;
+  lines.reserve(lines_.size());
+  for (const auto& l : lines_)
+    if (remap[l.dataset] != UINT32_MAX)
+      lines.push_back({l.energy, l.intensity, remap[l.dataset], l.transition});
+  lines_ = std::move(lines);
+}
+
+std::set<uint16_t> GammaIndex::chains() const
+{
+  std::set<uint16_t> ret;
+  for (const auto& d : datasets_)
+    ret.insert(d.A);
+  return ret;
+}
+
+void GammaIndex::sort()
+{
+  std::stable_sort(lines_.begin(), lines_.end(),
+                   [](const Line& a, const Line& b)
+                   { return a.energy < b.energy; });
+  update_totals();
+}
+
+void GammaIndex::update_totals()
+{
+  totals_.assign(datasets_.size(), 0.0);
+  for (const auto& l : lines_)
+    if (std::isfinite(l.intensity))
+      totals_[l.dataset] += l.intensity;
+}
+
+const GammaIndex::Dataset& GammaIndex::dataset(uint32_t idx) const
+{
+  return datasets_.at(idx);
+}
+
+size_t GammaIndex::dataset_count() const
+{
+  return datasets_.size();
+}
+
+double GammaIndex::total_intensity(uint32_t idx) const
+{
+  return totals_.at(idx);
+}
+
+const CascadeClosure& GammaIndex::cascade(uint32_t idx) const
+{
+  return cascades_.at(idx);
+}
+
+const GammaIndex::Line& GammaIndex::line(size_t idx) const
+{
+  return lines_.at(idx);
+}
+
+std::pair<size_t, size_t> GammaIndex::range(double low, double high) const
+{
+  auto first = std::lower_bound(lines_.begin(), lines_.end(), low,
+                                [](const Line& l, double e)
+                                { return l.energy < e; });
+  auto last = std::upper_bound(first, lines_.end(), high,
+                               [](double e, const Line& l)
+                               { return e < l.energy; });
+  return {size_t(first - lines_.begin()), size_t(last - lines_.begin())};
+}
+
+bool GammaIndex::passes(const Line& line, const Query& query) const
+{
+  if ((query.min_intensity > 0) &&
+      !(line.intensity >= query.min_intensity))
+    return false;
+
+  double hl = datasets_[line.dataset].parent_halflife;
+  if ((query.min_halflife > 0) || std::isfinite(query.max_halflife))
+  {
+    if (std::isnan(hl))
+      return false;
+    if ((hl < query.min_halflife) || (hl > query.max_halflife))
+      return false;
+  }
+  return true;
+}
+
+std::vector<size_t> GammaIndex::find(const Query& query) const
+{
+  std::vector<size_t> ret;
+  auto r = range(query.energy - query.tolerance,
+                 query.energy + query.tolerance);
+  for (size_t i = r.first; i < r.second; ++i)
+    if (passes(lines_[i], query))
+      ret.push_back(i);
+  return ret;
+}
+
+template <typename T>
+static void write_pod(std::ostream& os, const T& v)
+{
+  os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+static bool read_pod(std::istream& is, T& v)
+{
+  return bool(is.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+static void write_string(std::ostream& os, const std::string& s)
+{
+  write_pod(os, uint32_t(s.size()));
+  os.write(s.data(), std::streamsize(s.size()));
+}
+
+static bool read_string(std::istream& is, std::string& s)
+{
+  uint32_t size {0};
+  if (!read_pod(is, size) || (size > (1u << 16)))
+    return false;
+  s.resize(size);
+  return bool(is.read(s.data(), size));
+}
+
+static void write_nid(std::ostream& os, const NuclideId& id)
+{
+  write_pod(os, uint8_t(id.valid()));
+  write_pod(os, id.A());
+  write_pod(os, id.Z());
+}
+
+static bool read_nid(std::istream& is, NuclideId& id)
+{
+  uint8_t valid {0};
+  uint16_t A {0}, Z {0};
+  if (!read_pod(is, valid) || !read_pod(is, A) || !read_pod(is, Z))
+    return false;
+  id = valid ? NuclideId::fromAZ(A, Z) : NuclideId();
+  return true;
+}
+
+bool GammaIndex::save(const std::string& path) const
+{
+  std::string tmp = path + ".tmp";
+  {
+    std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+    if (!os)
+      return false;
+
+    write_pod(os, kGammaIndexMagic);
+    write_pod(os, kGammaIndexVersion);
+    write_pod(os, uint32_t(datasets_.size()));
+    write_pod(os, uint32_t(lines_.size()));
+
+    for (size_t i = 0; i < datasets_.size(); ++i)
+    {
+      const auto& d = datasets_[i];
+      write_pod(os, d.A);
+      write_nid(os, d.daughter);
+      write_nid(os, d.parent);
+      write_pod(os, d.parent_halflife);
+      write_pod(os, d.daughter_halflife);
+      write_string(os, d.name);
+      write_string(os, d.mode);
+      cascades_[i].write(os);
+    }
+
+    for (const auto& l : lines_)
+    {
+      write_pod(os, l.energy);
+      write_pod(os, l.intensity);
+      write_pod(os, l.dataset);
+      write_pod(os, l.transition);
+    }
+
+    if (!os.flush())
+      return false;
+  }
+  return !std::rename(tmp.c_str(), path.c_str());
+}
+
+bool GammaIndex::load(const std::string& path)
+{
+  clear();
+
+  std::ifstream is(path, std::ios::binary);
+  if (!is)
+    return false;
+
+  uint32_t magic {0}, version {0}, dataset_count {0}, line_count {0};
+  if (!read_pod(is, magic) || (magic != kGammaIndexMagic) ||
+      !read_pod(is, version) || (version != kGammaIndexVersion) ||
+      !read_pod(is, dataset_count) || !read_pod(is, line_count))
+    return false;
+
+  // a truncated or corrupt file must not make us allocate for counts
+  // it cannot hold
+  auto start = is.tellg();
+  is.seekg(0, std::ios::end);
+  auto end = is.tellg();
+  is.seekg(start);
+  if ((start < 0) || (end < start) || !is ||
+      (dataset_count * kMinDatasetBytes + line_count * kLineBytes
+       > uint64_t(end - start)))
+    return false;
+
+  datasets_.resize(dataset_count);
+  cascades_.resize(dataset_count);
+  for (size_t i = 0; i < dataset_count; ++i)
+    if (!read_pod(is, datasets_[i].A) ||
+        !read_nid(is, datasets_[i].daughter) ||
+        !read_nid(is, datasets_[i].parent) ||
+        !read_pod(is, datasets_[i].parent_halflife) ||
+        !read_pod(is, datasets_[i].daughter_halflife) ||
+        !read_string(is, datasets_[i].name) ||
+        !read_string(is, datasets_[i].mode) ||
+        !cascades_[i].read(is))
+    {
+      clear();
+      return false;
+    }
+
+  lines_.resize(line_count);
+  for (auto& l : lines_)
+    if (!read_pod(is, l.energy) ||
+        !read_pod(is, l.intensity) ||
+        !read_pod(is, l.dataset) ||
+        !read_pod(is, l.transition) ||
+        (l.dataset >= dataset_count) ||
+        (l.transition >= cascades_[l.dataset].transition_count()))
+    {
+      clear();
+      return false;
+    }
+
+  update_totals();
+  return true;
+}
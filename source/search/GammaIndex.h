@@ -0,0 +1,89 @@
+#pragma once
+
+#include <NucData/nid.h>
+#include <NucData/CascadeClosure.h>
+#include <util/double_consts.h>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+class DaughterParser;
+
+/**
+ * @brief Database-wide table of gamma lines, sorted by energy.
+ *
+ * Every decay dataset contributes one entry per transition of its daughter.
+ * Lines refer to their dataset by index, datasets carry what is needed to
+ * locate the decay again in the selection tree and to filter on the parent.
+ * The index is rebuilt per mass chain, mirroring the decay tree cache.
+ */
+class GammaIndex
+{
+public:
+  struct Dataset
+  {
+    uint16_t A {0};
+    NuclideId daughter;
+    NuclideId parent;
+    double parent_halflife {kDoubleNaN}; // seconds, +inf if stable
+    double daughter_halflife {kDoubleNaN}; // ground state, as above
+    std::string name;                    // decay name as listed by DaughterParser
+    std::string mode;
+  };
+
+  struct Line
+  {
+    double energy;       // keV
+    double intensity;    // per 100 decays, NaN if unknown
+    uint32_t dataset;
+    uint32_t transition; // position among the dataset's transitions
+  };
+
+  struct Query
+  {
+    double energy {0};
+    double tolerance {0.5};
+    double min_intensity {0};
+    double min_halflife {0};
+    double max_halflife {kDoubleInf};
+  };
+
+  void clear();
+  bool empty() const;
+  size_t size() const;
+
+  // (re)index all decays of a mass chain; call sort() once done adding
+  void add_chain(uint16_t A, const DaughterParser& dp);
+  void remove_chains(const std::set<uint16_t>& masses);
+  std::set<uint16_t> chains() const;
+  void sort();
+
+  const Dataset& dataset(uint32_t idx) const;
+  size_t dataset_count() const;
+  // summed intensity of all lines of a dataset
+  double total_intensity(uint32_t idx) const;
+  // cascades of the daughter as seen in the dataset, by Line::transition
+  const CascadeClosure& cascade(uint32_t idx) const;
+  const Line& line(size_t idx) const;
+
+  // indices of lines within [energy - tolerance, energy + tolerance]
+  // whose intensity and parent half-life pass the filters, by energy
+  std::vector<size_t> find(const Query& query) const;
+
+  // lines [first, last) with energies in [low, high]
+  std::pair<size_t, size_t> range(double low, double high) const;
+
+  bool save(const std::string& path) const;
+  bool load(const std::string& path);
+
+private:
+  std::vector<Dataset> datasets_;
+  std::vector<CascadeClosure> cascades_;
+  std::vector<Line> lines_;
+  std::vector<double> totals_;
+
+  bool passes(const Line& line, const Query& query) const;
+  void update_totals();
+};
@@ -0,0 +1,107 @@
+#include <search/NuclideTable.h>
+#include <search/GammaIndex.h>
+
+#include <util/logger.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <sstream>
+
+void NuclideTable::clear()
+{
+  ids_.clear();
+  halflife_.clear();
+  abundance_.clear();
+  capture_.clear();
+}
+
+uint32_t NuclideTable::find(const NuclideId& id) const
+{
+  auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+  if ((it == ids_.end()) || (*it != id))
+    return none;
+  return uint32_t(it - ids_.begin());
+}
+
+uint32_t NuclideTable::insert(const NuclideId& id)
+{
+  auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+  size_t row = size_t(it - ids_.begin());
+  if ((it != ids_.end()) && (*it == id))
+    return uint32_t(row);
+
+  ids_.insert(it, id);
+  halflife_.insert(halflife_.begin() + long(row), kDoubleNaN);
+  abundance_.insert(abundance_.begin() + long(row), 0.0);
+  capture_.insert(capture_.begin() + long(row), kDoubleNaN);
+  return uint32_t(row);
+}
+
+void NuclideTable::add_halflives(const GammaIndex& index)
+{
+  for (uint32_t i = 0; i < index.dataset_count(); ++i)
+  {
+    const auto& d = index.dataset(i);
+    if (!d.daughter.composition_known() || std::isnan(d.daughter_halflife))
+      continue;
+    halflife_[insert(d.daughter)] = d.daughter_halflife;
+  }
+
+  for (uint32_t i = 0; i < index.dataset_count(); ++i)
+  {
+    const auto& d = index.dataset(i);
+    if (!d.parent.composition_known() || std::isnan(d.parent_halflife))
+      continue;
+    double& hl = halflife_[insert(d.parent)];
+    if (std::isnan(hl))
+      hl = d.parent_halflife;
+  }
+}
+
+size_t NuclideTable::load_capture_data(std::istream& is)
+{
+  size_t count {0};
+  std::string line;
+  while (std::getline(is, line))
+  {
+    line = line.substr(0, line.find('#'));
+    boost::trim(line);
+    if (line.empty())
+      continue;
+
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of(","));
+    if (fields.size() < 4)
+    {
+      WARN("<NuclideTable> Malformed capture data '{}'", line);
+      continue;
+    }
+
+    int16_t Z = NuclideId::zOfSymbol(boost::to_upper_copy(boost::trim_copy(fields[0])));
+    std::istringstream values(fields[1] + " " + fields[2] + " " + fields[3]);
+    uint16_t A {0};
+    double abundance {0}, sigma {0};
+    if ((Z < 0) || !(values >> A >> abundance >> sigma) || (A < uint16_t(Z)))
+    {
+      WARN("<NuclideTable> Malformed capture data '{}'", line);
+      continue;
+    }
+
+    uint32_t row = insert(NuclideId::fromAZ(A, uint16_t(Z)));
+    abundance_[row] = abundance;
+    capture_[row] = sigma;
+    ++count;
+  }
+  return count;
+}
+
+bool NuclideTable::stable(uint32_t row) const
+{
+  double hl = halflife_[row];
+  if (std::isnan(hl))
+    return abundance_[row] > 0;
+  return std::isinf(hl);
+}
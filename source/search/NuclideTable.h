@@ -0,0 +1,53 @@
+#pragma once
+
+#include <NucData/nid.h>
+#include <util/double_consts.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+class GammaIndex;
+
+/**
+ * @brief Per-nuclide properties in columns, sorted by NuclideId.
+ *
+ * Ground-state half-lives come from the decay datasets of a GammaIndex,
+ * natural abundances and thermal capture cross-sections from a bundled
+ * table. Rows are looked up by binary search, so joins against the index
+ * stay cheap.
+ */
+class NuclideTable
+{
+public:
+  static constexpr uint32_t none = UINT32_MAX;
+
+  void clear();
+  size_t size() const { return ids_.size(); }
+
+  // ground states of daughters first, parents only fill the gaps since
+  // their datasets may describe an isomer
+  void add_halflives(const GammaIndex& index);
+
+  // lines of "symbol,A,abundance [%],sigma [b]", '#' starts a comment;
+  // returns the number of rows read
+  size_t load_capture_data(std::istream& is);
+
+  uint32_t find(const NuclideId& id) const;
+
+  const NuclideId& id(uint32_t row) const { return ids_[row]; }
+  double halflife(uint32_t row) const { return halflife_[row]; }   // seconds, +inf if stable
+  double abundance(uint32_t row) const { return abundance_[row]; } // percent, 0 if not natural
+  double capture(uint32_t row) const { return capture_[row]; }     // barn, NaN if unknown
+
+  // stable as far as known, primordial nuclides without decay data count too
+  bool stable(uint32_t row) const;
+
+private:
+  std::vector<NuclideId> ids_;
+  std::vector<double> halflife_;
+  std::vector<double> abundance_;
+  std::vector<double> capture_;
+
+  uint32_t insert(const NuclideId& id);
+};
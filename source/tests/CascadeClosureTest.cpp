@@ -0,0 +1,236 @@
+#include <NucData/CascadeClosure.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+Energy energy(double e)
+{
+  return Energy(e, Uncert::SignMagnitudeDefined);
+}
+
+// 600 ---> 400 and 600 ---> 250, 250 is held up for 1 ms:
+//
+//   600  g200 -> 400, g350 -> 250
+//   400  g300 -> 100
+//   250  g150 -> 100, g250 -> 0   (1 ms)
+//   100  g100 -> 0
+//     0
+Nuclide branched_nuclide()
+{
+  Nuclide ret(NuclideId::fromAZ(152, 62));
+  for (double l : {0.0, 100.0, 400.0, 600.0})
+    ret.add_level(Level(energy(l), SpinSet()));
+  ret.add_level(Level(energy(250), SpinSet(), HalfLife(1, false, "ms")));
+
+  const std::vector<std::pair<double, double>> gammas
+  {
+    {600, 200}, {600, 350}, {400, 300}, {250, 150}, {250, 250}, {100, 100}
+  };
+  for (const auto& g : gammas)
+  {
+    Transition t(energy(g.second), Uncert(10, 2, Uncert::SignMagnitudeDefined));
+    t.set_from(energy(g.first));
+    ret.add_transition_from(t);
+  }
+  return ret;
+}
+
+// position of a gamma in Nuclide::transitions(), as the closure counts them
+uint32_t index_of(const Nuclide& nuclide, double e)
+{
+  uint32_t i {0};
+  for (const auto& t : nuclide.transitions())
+  {
+    if (t.first.value().value() == e)
+      return i;
+    ++i;
+  }
+  return CascadeClosure::none;
+}
+
+template <typename T>
+void write_vector(std::ostream& os, const std::vector<T>& v)
+{
+  uint32_t size = uint32_t(v.size());
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(reinterpret_cast<const char*>(v.data()),
+           std::streamsize(v.size() * sizeof(T)));
+}
+
+// tables as CascadeClosure::write lays them out
+struct Tables
+{
+  std::vector<uint32_t> from, to;
+  std::vector<double> halflife;
+  std::vector<uint32_t> depop_first, depop;
+  std::vector<uint64_t> below;
+
+  std::string bytes() const
+  {
+    std::ostringstream os;
+    write_vector(os, from);
+    write_vector(os, to);
+    write_vector(os, halflife);
+    write_vector(os, depop_first);
+    write_vector(os, depop);
+    write_vector(os, below);
+    return os.str();
+  }
+};
+
+// one gamma from level 1 to level 0
+Tables single_gamma()
+{
+  Tables t;
+  t.from = {1};
+  t.to = {0};
+  t.halflife = {kDoubleNaN, kDoubleNaN};
+  t.depop_first = {0, 0, 1};
+  t.depop = {0};
+  t.below = {0, 1};
+  return t;
+}
+
+bool reads(const std::string& bytes)
+{
+  std::istringstream is(bytes);
+  CascadeClosure c;
+  return c.read(is);
+}
+
+}
+
+TEST(CascadeClosure, MatchesNuclideCoincidences)
+{
+  auto nuclide = branched_nuclide();
+  auto transitions = nuclide.transitions();
+  ASSERT_EQ(transitions.size(), 6u);
+
+  CascadeClosure closure(nuclide);
+  ASSERT_EQ(closure.transition_count(), transitions.size());
+  ASSERT_EQ(closure.level_count(), nuclide.levels().size());
+
+  const size_t w = closure.words();
+  auto rows = closure.coincidence_rows();
+  ASSERT_EQ(rows.size(), transitions.size() * w);
+
+  uint32_t a {0};
+  for (const auto& ta : transitions)
+  {
+    auto expected = nuclide.coincidences(ta.first);
+    uint32_t b {0};
+    for (const auto& tb : transitions)
+    {
+      SCOPED_TRACE(ta.first.to_string() + " / " + tb.first.to_string());
+      bool coincident = expected.count(tb.first) > 0;
+      EXPECT_EQ(closure.coincident(a, b), coincident);
+      EXPECT_EQ(closure.coincident(a, b, kDoubleInf), coincident);
+      EXPECT_EQ(bool((rows[a * w + b / 64] >> (b % 64)) & 1), coincident);
+      ++b;
+    }
+    ++a;
+  }
+}
+
+TEST(CascadeClosure, HalfLifeLimitCutsCascade)
+{
+  auto nuclide = branched_nuclide();
+  CascadeClosure closure(nuclide);
+  auto g = [&](double e) { return index_of(nuclide, e); };
+
+  EXPECT_TRUE(closure.follows(g(350), g(150)));
+  EXPECT_TRUE(closure.follows(g(350), g(100)));
+  EXPECT_FALSE(closure.follows(g(150), g(350)));
+  EXPECT_FALSE(closure.coincident(g(200), g(350)));
+
+  // above the 1 ms of the 250 level, nothing changes
+  EXPECT_TRUE(closure.follows(g(350), g(150), 1.0));
+  EXPECT_TRUE(closure.coincident(g(100), g(350), 1.0));
+
+  // below it, the cascade stops at 250
+  EXPECT_FALSE(closure.follows(g(350), g(150), 1e-6));
+  EXPECT_FALSE(closure.follows(g(350), g(250), 1e-6));
+  EXPECT_FALSE(closure.follows(g(350), g(100), 1e-6));
+  EXPECT_FALSE(closure.coincident(g(100), g(350), 1e-6));
+
+  // but not the branch through the prompt 400 level, nor what leaves 250
+  EXPECT_TRUE(closure.follows(g(200), g(300), 1e-6));
+  EXPECT_TRUE(closure.follows(g(200), g(100), 1e-6));
+  EXPECT_TRUE(closure.follows(g(150), g(100), 1e-6));
+
+  EXPECT_FALSE(closure.follows(g(350), 1000));
+  EXPECT_FALSE(closure.follows(1000, g(350), 1.0));
+}
+
+TEST(CascadeClosure, WriteReadRoundTrip)
+{
+  auto nuclide = branched_nuclide();
+  CascadeClosure closure(nuclide);
+
+  std::stringstream ss;
+  closure.write(ss);
+  CascadeClosure loaded;
+  ASSERT_TRUE(loaded.read(ss));
+  EXPECT_EQ(loaded.transition_count(), closure.transition_count());
+  EXPECT_EQ(loaded.level_count(), closure.level_count());
+  EXPECT_EQ(loaded.coincidence_rows(), closure.coincidence_rows());
+  for (uint32_t a = 0; a < closure.transition_count(); ++a)
+    for (uint32_t b = 0; b < closure.transition_count(); ++b)
+      EXPECT_EQ(loaded.follows(a, b, 1e-6), closure.follows(a, b, 1e-6));
+}
+
+TEST(CascadeClosure, ReadRejectsInconsistentTables)
+{
+  ASSERT_TRUE(reads(single_gamma().bytes()));
+
+  auto good = single_gamma().bytes();
+  EXPECT_FALSE(reads(""));
+  EXPECT_FALSE(reads(good.substr(0, good.size() - 1)));
+
+  auto t = single_gamma();
+  t.to = {0, 0};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.from = {2};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.to = {5};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.depop_first = {0, 1};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.depop_first = {0, 0, 2};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.depop_first = {0, 2, 1};
+  t.depop = {0};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.depop = {1};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  t = single_gamma();
+  t.below = {0};
+  EXPECT_FALSE(reads(t.bytes()));
+
+  // a size the stream cannot back must not be allocated
+  std::string huge = good;
+  uint32_t size = 0xffffffff;
+  huge.replace(0, sizeof(size), reinterpret_cast<const char*>(&size),
+               sizeof(size));
+  EXPECT_FALSE(reads(huge));
+}
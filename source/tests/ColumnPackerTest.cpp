@@ -0,0 +1,198 @@
+#include <SchemeEditor/ColumnPacker.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const double pitch = 20.0;
+const double step = 20.0 * std::tan(60.0 / 180.0 * M_PI);
+
+// what a transition takes up in one column
+struct Segment
+{
+  size_t transition;
+  double from;
+  double to;
+};
+
+// own column from the lower level to the label's first step, and one
+// step of the label in each column it crosses on the right, as the
+// packer books them
+std::vector<std::vector<Segment>> occupancy(const std::vector<ColumnFootprint>& fps,
+                                            const std::vector<int>& columns,
+                                            double step)
+{
+  std::vector<std::vector<Segment>> ret;
+  auto add = [&ret](int c, Segment s)
+  {
+    if (c >= int(ret.size()))
+      ret.resize(c + 1);
+    ret[c].push_back(s);
+  };
+
+  for (size_t i = 0; i < fps.size(); ++i)
+  {
+    const auto& f = fps[i];
+    int c = columns[i];
+    add(c, {i, f.low, std::max(f.base, std::min(f.high, f.base + 0.5 * step))});
+    for (int k = 1; (k <= c) && (f.base + (k - 0.5) * step < f.high); ++k)
+      add(c - k, {i, f.base + (k - 0.5) * step,
+                  std::min(f.high, f.base + (k + 0.5) * step)});
+  }
+  return ret;
+}
+
+// the column-by-column scan that packColumns replaced
+std::vector<int> reference_columns(const std::vector<ColumnFootprint>& fps,
+                                   double step)
+{
+  std::vector<int> columns(fps.size(), 0);
+  std::vector<size_t> order(fps.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&fps](size_t a, size_t b)
+  {
+    return fps[a].low < fps[b].low;
+  });
+
+  std::vector<double> top;
+  auto top_of = [&top](int c)
+  {
+    return (c < int(top.size())) ? top[c]
+                                 : -std::numeric_limits<double>::infinity();
+  };
+  auto raise = [&top](int c, double y)
+  {
+    if (c >= int(top.size()))
+      top.resize(c + 1, -std::numeric_limits<double>::infinity());
+    top[c] = std::max(top[c], y);
+  };
+
+  for (auto i : order)
+  {
+    const auto& f = fps[i];
+    int reach = 0;
+    while (f.base + (reach + 0.5) * step < f.high)
+      ++reach;
+
+    int c = 0;
+    for (;; ++c)
+    {
+      if (top_of(c) > f.low)
+        continue;
+      bool fits = true;
+      for (int k = 1; fits && (k <= reach) && (k <= c); ++k)
+        fits = !(top_of(c - k) > f.base + (k - 0.5) * step);
+      if (fits)
+        break;
+    }
+
+    columns[i] = c;
+    raise(c, std::max(f.base, std::min(f.high, f.base + 0.5 * step)));
+    for (int k = 1; (k <= reach) && (k <= c); ++k)
+      raise(c - k, std::min(f.high, f.base + (k + 0.5) * step));
+  }
+  return columns;
+}
+
+// gammas between random levels, with labels up to a few steps long
+std::vector<ColumnFootprint> random_scheme(std::mt19937& rng)
+{
+  int levels = std::uniform_int_distribution<int>(2, 60)(rng);
+  int gammas = std::uniform_int_distribution<int>(1, 200)(rng);
+
+  std::vector<double> y(levels, 0.0);
+  std::uniform_real_distribution<double> gap(5.0, 80.0);
+  for (int i = 1; i < levels; ++i)
+    y[i] = y[i - 1] + gap(rng);
+
+  std::uniform_int_distribution<int> level(0, levels - 1);
+  std::uniform_real_distribution<double> label(0.0, 4.0 * step);
+  std::vector<ColumnFootprint> ret;
+  for (int i = 0; i < gammas; ++i)
+  {
+    int a = level(rng);
+    int b = level(rng);
+    ColumnFootprint f;
+    f.low = y[std::min(a, b)];
+    f.base = y[std::max(a, b)];
+    f.high = f.base + label(rng);
+    ret.push_back(f);
+  }
+  return ret;
+}
+
+}
+
+TEST(ColumnPacker, DegenerateInputGivesColumnZero)
+{
+  EXPECT_TRUE(packColumns({}, pitch, step).empty());
+
+  std::vector<ColumnFootprint> fps(3, ColumnFootprint{0, 10, 50});
+  const std::vector<int> zeros(fps.size(), 0);
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(packColumns(fps, 0, step), zeros);
+  EXPECT_EQ(packColumns(fps, -pitch, step), zeros);
+  EXPECT_EQ(packColumns(fps, nan, step), zeros);
+  EXPECT_EQ(packColumns(fps, pitch, 0), zeros);
+  EXPECT_EQ(packColumns(fps, pitch, -step), zeros);
+  EXPECT_EQ(packColumns(fps, pitch, nan), zeros);
+}
+
+TEST(ColumnPacker, StacksDisjointAndSpreadsOverlapping)
+{
+  // one above the other share a column
+  std::vector<ColumnFootprint> stacked {{0, 100, 105}, {200, 300, 305}};
+  EXPECT_EQ(packColumns(stacked, pitch, step), (std::vector<int>{0, 0}));
+
+  // side by side do not
+  std::vector<ColumnFootprint> parallel {{0, 100, 105}, {50, 150, 155}};
+  EXPECT_EQ(packColumns(parallel, pitch, step), (std::vector<int>{0, 1}));
+
+  // a long label keeps the column on its right clear above its base,
+  // where the last one would fit otherwise
+  std::vector<ColumnFootprint> labelled {{0, 50, 55},
+                                         {0, 100, 100 + 3 * step},
+                                         {100, 200, 205}};
+  EXPECT_EQ(packColumns(labelled, pitch, step), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(ColumnPacker, RandomSchemesKeepInvariants)
+{
+  std::mt19937 rng(152);
+  for (int n = 0; n < 3000; ++n)
+  {
+    SCOPED_TRACE("scheme " + std::to_string(n));
+    auto fps = random_scheme(rng);
+    auto columns = packColumns(fps, pitch, step);
+    ASSERT_EQ(columns.size(), fps.size());
+
+    // same columns as the plain scan
+    ASSERT_EQ(columns, reference_columns(fps, step));
+
+    for (auto c : columns)
+      ASSERT_GE(c, 0);
+
+    // no two transitions, nor a label and a transition on its right,
+    // share any height of a column
+    for (auto& col : occupancy(fps, columns, step))
+    {
+      std::sort(col.begin(), col.end(), [](const Segment& a, const Segment& b)
+      {
+        return a.from < b.from;
+      });
+      for (size_t i = 1; i < col.size(); ++i)
+        ASSERT_LE(col[i - 1].to, col[i].from)
+            << "transitions " << col[i - 1].transition
+            << " and " << col[i].transition;
+    }
+  }
+}
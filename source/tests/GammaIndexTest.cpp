@@ -0,0 +1,285 @@
+#include <search/GammaIndex.h>
+#include <ensdf/Parser.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string field(std::string line, size_t column, const std::string& value)
+{
+  line.replace(column - 1, value.size(), value);
+  return line;
+}
+
+std::string record(const std::string& nucid, char type)
+{
+  std::string ret(80, ' ');
+  ret = field(ret, 1, nucid);
+  ret[7] = type;
+  return ret;
+}
+
+// two B- decays into 152SM, from a long- and a short-lived parent
+void write_chain(const fs::path& file)
+{
+  std::ofstream os(file);
+  struct Gamma { const char* energy; const char* intensity; };
+  auto dataset = [&os](const std::string& parent, const std::string& halflife,
+                       const std::vector<const char*>& levels,
+                       const std::vector<std::vector<Gamma>>& gammas)
+  {
+    os << field(record("152SM", ' '), 10,
+                parent + " B- DECAY (" + halflife + ")") << "\n";
+    auto p = record(parent, 'P');
+    p = field(p, 10, "0.0");
+    p = field(p, 22, "3-");
+    p = field(p, 40, halflife);
+    p = field(p, 65, "1874.3");
+    os << p << "\n";
+    os << field(field(record("152SM", 'N'), 10, "1.0"), 22, "1.0") << "\n";
+    for (size_t l = 0; l < levels.size(); ++l)
+    {
+      os << field(field(record("152SM", 'L'), 10, levels[l]), 22, "2+") << "\n";
+      for (const auto& g : gammas[l])
+        os << field(field(field(record("152SM", 'G'), 10, g.energy),
+                          22, g.intensity), 32, "E2") << "\n";
+    }
+    os << std::string(80, ' ') << "\n";
+  };
+
+  dataset("152EU", "13.537 Y",
+          {"0.0", "121.78", "366.48", "810.45"},
+          {{}, {{"121.78", "28.5"}}, {{"244.70", "7.5"}},
+           {{"443.96", "2.8"}, {"688.67", "0.85"}}});
+  dataset("152PM", "4.12 M",
+          {"0.0", "121.78", "366.48"},
+          {{}, {{"121.78", "30.0"}}, {{"244.70", "0.5"}}});
+}
+
+class GammaIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = fs::temp_directory_path()
+        / ("nuclei-gamma-index-" + std::to_string(std::random_device()()));
+    fs::create_directories(dir_);
+    write_chain(dir_ / "ensdf.152");
+    DaughterParser dp(152, dir_.string());
+    index_.add_chain(152, dp);
+    index_.sort();
+  }
+
+  void TearDown() override
+  {
+    fs::remove_all(dir_);
+  }
+
+  std::string path(const std::string& name) const
+  {
+    return (dir_ / name).string();
+  }
+
+  std::vector<char> bytes(const std::string& file) const
+  {
+    std::ifstream is(file, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(is), {});
+  }
+
+  void write_bytes(const std::string& file, const std::vector<char>& b) const
+  {
+    std::ofstream os(file, std::ios::binary | std::ios::trunc);
+    os.write(b.data(), std::streamsize(b.size()));
+  }
+
+  template <typename T>
+  void patch(std::vector<char>& b, size_t offset, T value) const
+  {
+    std::memcpy(b.data() + offset, &value, sizeof(T));
+  }
+
+  // loading must fail and leave nothing behind
+  void expect_rejected(const std::vector<char>& b)
+  {
+    write_bytes(path("bad.idx"), b);
+    GammaIndex loaded;
+    EXPECT_FALSE(loaded.load(path("bad.idx")));
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_EQ(loaded.dataset_count(), 0u);
+  }
+
+  fs::path dir_;
+  GammaIndex index_;
+};
+
+}
+
+TEST_F(GammaIndexTest, IndexesEveryGammaByEnergy)
+{
+  ASSERT_EQ(index_.dataset_count(), 2u);
+  ASSERT_EQ(index_.size(), 6u);
+  for (size_t i = 1; i < index_.size(); ++i)
+    EXPECT_LE(index_.line(i - 1).energy, index_.line(i).energy);
+  EXPECT_EQ(index_.chains(), std::set<uint16_t>{152});
+}
+
+TEST_F(GammaIndexTest, RangeIsInclusiveAndBounded)
+{
+  auto all = index_.range(0, 2000);
+  EXPECT_EQ(all.first, 0u);
+  EXPECT_EQ(all.second, index_.size());
+
+  // both datasets have a 121.78 line
+  auto exact = index_.range(121.78, 121.78);
+  EXPECT_EQ(exact.second - exact.first, 2u);
+
+  auto window = index_.range(200, 450);
+  ASSERT_EQ(window.second - window.first, 3u);
+  EXPECT_DOUBLE_EQ(index_.line(window.first).energy, 244.70);
+  EXPECT_DOUBLE_EQ(index_.line(window.second - 1).energy, 443.96);
+
+  auto below = index_.range(0, 100);
+  EXPECT_EQ(below.first, below.second);
+  auto above = index_.range(1000, 2000);
+  EXPECT_EQ(above.first, index_.size());
+  EXPECT_EQ(above.second, index_.size());
+  auto inverted = index_.range(450, 200);
+  EXPECT_EQ(inverted.first, inverted.second);
+
+  EXPECT_EQ(GammaIndex().range(0, 2000), std::make_pair(size_t(0), size_t(0)));
+}
+
+TEST_F(GammaIndexTest, FindFiltersOnIntensityAndHalfLife)
+{
+  GammaIndex::Query q;
+  q.energy = 244.7;
+  q.tolerance = 0.5;
+  EXPECT_EQ(index_.find(q).size(), 2u);
+
+  q.min_intensity = 1.0;
+  auto strong = index_.find(q);
+  ASSERT_EQ(strong.size(), 1u);
+  EXPECT_EQ(index_.dataset(index_.line(strong[0]).dataset).parent.symbolicName(),
+            NuclideId::fromAZ(152, 63).symbolicName());
+
+  q.min_intensity = 0;
+  q.max_halflife = 3600;
+  auto short_lived = index_.find(q);
+  ASSERT_EQ(short_lived.size(), 1u);
+  EXPECT_NEAR(index_.dataset(index_.line(short_lived[0]).dataset).parent_halflife,
+              4.12 * 60, 1e-6);
+
+  q.max_halflife = kDoubleInf;
+  q.min_halflife = 3600;
+  auto long_lived = index_.find(q);
+  ASSERT_EQ(long_lived.size(), 1u);
+  EXPECT_NE(long_lived[0], short_lived[0]);
+
+  q.energy = 1000;
+  q.min_halflife = 0;
+  EXPECT_TRUE(index_.find(q).empty());
+}
+
+TEST_F(GammaIndexTest, SaveLoadRoundTrip)
+{
+  ASSERT_TRUE(index_.save(path("gammas.idx")));
+  EXPECT_FALSE(fs::exists(path("gammas.idx.tmp")));
+
+  GammaIndex loaded;
+  ASSERT_TRUE(loaded.load(path("gammas.idx")));
+  ASSERT_EQ(loaded.size(), index_.size());
+  ASSERT_EQ(loaded.dataset_count(), index_.dataset_count());
+
+  for (size_t i = 0; i < index_.size(); ++i)
+  {
+    const auto& a = index_.line(i);
+    const auto& b = loaded.line(i);
+    EXPECT_EQ(a.energy, b.energy);
+    EXPECT_EQ(a.intensity, b.intensity);
+    EXPECT_EQ(a.dataset, b.dataset);
+    EXPECT_EQ(a.transition, b.transition);
+  }
+
+  for (uint32_t d = 0; d < index_.dataset_count(); ++d)
+  {
+    const auto& a = index_.dataset(d);
+    const auto& b = loaded.dataset(d);
+    EXPECT_EQ(a.A, b.A);
+    EXPECT_EQ(a.daughter, b.daughter);
+    EXPECT_EQ(a.parent, b.parent);
+    EXPECT_EQ(a.parent_halflife, b.parent_halflife);
+    EXPECT_EQ(a.name, b.name);
+    EXPECT_EQ(a.mode, b.mode);
+    EXPECT_DOUBLE_EQ(index_.total_intensity(d), loaded.total_intensity(d));
+
+    const auto& ca = index_.cascade(d);
+    const auto& cb = loaded.cascade(d);
+    ASSERT_EQ(ca.transition_count(), cb.transition_count());
+    EXPECT_EQ(ca.coincidence_rows(), cb.coincidence_rows());
+  }
+
+  GammaIndex::Query q;
+  q.energy = 121.78;
+  EXPECT_EQ(loaded.find(q), index_.find(q));
+}
+
+TEST_F(GammaIndexTest, LoadRejectsBadFiles)
+{
+  ASSERT_TRUE(index_.save(path("gammas.idx")));
+  const auto good = bytes(path("gammas.idx"));
+  // header: magic, version, dataset count, line count
+  const size_t header = 4 * sizeof(uint32_t);
+  // each line ends in its dataset and transition numbers
+  const size_t last_dataset = good.size() - 2 * sizeof(uint32_t);
+  const size_t last_transition = good.size() - sizeof(uint32_t);
+
+  GammaIndex loaded;
+  EXPECT_FALSE(loaded.load(path("missing.idx")));
+
+  for (size_t size : {size_t(0), header - 1, header, good.size() / 2,
+                      good.size() - 1})
+  {
+    SCOPED_TRACE("truncated to " + std::to_string(size));
+    expect_rejected(std::vector<char>(good.begin(), good.begin() + size));
+  }
+
+  auto b = good;
+  patch(b, 0, uint32_t(0));
+  expect_rejected(b);
+
+  b = good;
+  patch(b, sizeof(uint32_t), uint32_t(2));
+  expect_rejected(b);
+
+  // counts the file cannot hold must not be trusted
+  b = good;
+  patch(b, 2 * sizeof(uint32_t), uint32_t(0x7fffffff));
+  expect_rejected(b);
+  b = good;
+  patch(b, 3 * sizeof(uint32_t), uint32_t(0x7fffffff));
+  expect_rejected(b);
+
+  b = good;
+  patch(b, last_dataset, uint32_t(index_.dataset_count()));
+  expect_rejected(b);
+
+  b = good;
+  patch(b, last_transition, uint32_t(1000));
+  expect_rejected(b);
+
+  // and the untouched file still loads
+  write_bytes(path("copy.idx"), good);
+  EXPECT_TRUE(loaded.load(path("copy.idx")));
+  EXPECT_EQ(loaded.size(), index_.size());
+}
@@ -0,0 +1,91 @@
+#include <ensdf/Translator.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// comment text in the style of ENSDF records, with abbreviations,
+// control sequences and markup
+std::vector<std::string> sample_texts()
+{
+  static const std::vector<std::string> fragments
+  {
+    "E(LEVEL): FROM LEAST-SQUARES FIT TO EG",
+    "{+152}EU B- DECAY (13.537 Y)",
+    "IG: RELATIVE TO |g(344)=100",
+    "MULT.,$D: FROM ALPHA(K)EXP AND SUBSHELL RATIOS",
+    "J|p: LOG {Ift}=7.2, 1U TRANSITION",
+    "T{-1/2}: WEIGHTED AVERAGE OF 2.3 NS {I3} (1985AB12)",
+    "%B{+-}=100; Q(G.S.)=1874.3 KEV {I7}",
+    "{Bbold} {Iitalic} {Uunder} {|small} {~big} &<> \"quoted\"",
+    "CC: FROM BRICC, 'FRAC' IS @ AND #SECTION#",
+    ""
+  };
+
+  std::vector<std::string> ret;
+  for (size_t i = 0; i < 600; ++i)
+  {
+    std::string s = fragments[i % fragments.size()];
+    if (i % 3)
+      s += " " + fragments[(i / 3) % fragments.size()];
+    if (i % 7 == 0)
+      s += " " + std::to_string(i);
+    ret.push_back(s);
+  }
+  return ret;
+}
+
+std::string translate(const std::string& s)
+{
+  const auto& t = Translator::instance();
+  return t.to_html(t.translate1(s)) + "|" + t.auth_capitalize(s)
+      + "|" + t.hist_key(s.substr(0, 3));
+}
+
+}
+
+// Threads race on constructing the singleton and then share it.
+TEST(Translator, ConcurrentUseMatchesSingleThreaded)
+{
+  const auto texts = sample_texts();
+  const size_t thread_count = 16;
+
+  std::vector<std::vector<std::string>> results(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    threads.emplace_back([&texts, &results, t]()
+    {
+      // start each thread at a different text
+      for (size_t i = 0; i < texts.size(); ++i)
+        results[t].push_back(translate(texts[(i + t * 37) % texts.size()]));
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  std::vector<std::string> expected;
+  for (const auto& s : texts)
+    expected.push_back(translate(s));
+
+  for (size_t t = 0; t < thread_count; ++t)
+  {
+    ASSERT_EQ(results[t].size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i)
+      EXPECT_EQ(results[t][i], expected[(i + t * 37) % texts.size()])
+          << "thread " << t << ", text " << texts[(i + t * 37) % texts.size()];
+  }
+}
+
+TEST(Translator, ToHtmlMarkup)
+{
+  const auto& t = Translator::instance();
+  EXPECT_EQ(t.to_html("{+152}EU"), "<sup>152</sup>EU");
+  EXPECT_EQ(t.to_html("T{-1/2}"), "T<sub>1/2</sub>");
+  EXPECT_EQ(t.to_html("{Ibold}"), "<i>bold</i>");
+}
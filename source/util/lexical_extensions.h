@@ -1,6 +1,8 @@
 #pragma once
 
 #include <util/string_extensions.h>
+#include <string_view>
+#include <charconv>
 #include <cmath>
 #include <iomanip>
 
@@ -38,38 +40,76 @@ inline std::string to_str_decimals(double number, int decimals = 0)
   return ss.str();
 }
 
+inline std::string_view trim_view(std::string_view s)
+{
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+    s.remove_prefix(1);
+  while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+    s.remove_suffix(1);
+  return s;
+}
+
+// like is_number + stod, but without allocating
+inline bool parse_double(std::string_view s, double& value)
+{
+  s = trim_view(s);
+  if (!s.empty() && (s[0] == '+'))
+  {
+    s.remove_prefix(1);
+    if (!s.empty() && (s[0] == '-'))
+      return false;
+  }
+  auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+  return (result.ec == std::errc()) && (result.ptr == s.data() + s.size());
+}
+
+// like stoi, parses the leading integer
+inline bool parse_int(std::string_view s, int& value)
+{
+  s = trim_view(s);
+  if (!s.empty() && (s[0] == '+'))
+  {
+    s.remove_prefix(1);
+    if (!s.empty() && (s[0] == '-'))
+      return false;
+  }
+  auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+  return (result.ec == std::errc());
+}
+
+// views into the string being parsed
 struct FloatDeconstructed
 {
-  std::string sign;
-  std::string mantissa;
-  std::string exponent;
+  std::string_view sign;
+  std::string_view mantissa;
+  std::string_view exponent;
 
-  inline void parse(std::string s)
+  inline void parse(std::string_view s)
   {
-    sign.clear();
-    mantissa.clear();
-    exponent.clear();
+    sign = {};
+    mantissa = {};
+    exponent = {};
 
-    trim(s);
+    s = trim_view(s);
     if (s.empty())
       return;
     if ((s[0] == '+') || (s[0] == '-'))
     {
-      sign = s[0];
-      s = s.substr(1, s.size() - 1);
+      sign = s.substr(0, 1);
+      s.remove_prefix(1);
     }
 
     size_t le = s.find('e');
     size_t lE = s.find('E');
-    if (le != std::string::npos)
+    if (le != std::string_view::npos)
     {
       mantissa = s.substr(0, le);
-      exponent = s.substr(le + 1, s.size() - le - 1);
+      exponent = s.substr(le + 1);
     }
-    else if (lE != std::string::npos)
+    else if (lE != std::string_view::npos)
     {
       mantissa = s.substr(0, lE);
-      exponent = s.substr(lE + 1, s.size() - lE - 1);
+      exponent = s.substr(lE + 1);
     }
     else
     {
@@ -78,13 +118,13 @@ struct FloatDeconstructed
   }
 
   FloatDeconstructed() {}
-  FloatDeconstructed(std::string s)
+  FloatDeconstructed(std::string_view s)
   {
     parse(s);
   }
 };
 
-inline uint16_t sig_digits(std::string st)
+inline uint16_t sig_digits(std::string_view st)
 {
   FloatDeconstructed parsed(st);
   if (parsed.mantissa.empty())
@@ -134,15 +174,16 @@ inline int16_t order_of(double val)
     return std::floor(std::log10(std::abs(val)));
 }
 
-inline double get_precision(std::string value)
+inline double get_precision(std::string_view value)
 {
   FloatDeconstructed parsed(value);
   if (parsed.mantissa.empty())
     return 0;
 
   int exponent = 0;
-  if (!parsed.exponent.empty() && is_number(parsed.exponent))
-    exponent = std::stoi(parsed.exponent);
+  double exponent_value;
+  if (parse_double(parsed.exponent, exponent_value))
+    parse_int(parsed.exponent, exponent);
 
   int sigpos = 0;
   size_t pointpos = parsed.mantissa.find('.');
@@ -1,8 +1,10 @@
 #include <util/logger.h>
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <algorithm>
 #include <fstream>
 #include <date/date.h>
 
@@ -69,7 +71,8 @@ namespace CustomLogger
 
 void initLogger(const spdlog::level::level_enum& LoggingLevel,
                 const std::string& log_file_name,
-                std::ostream* gui_stream)
+                std::ostream* gui_stream,
+                const AsyncOptions& async)
 {
   closeLogger();
 
@@ -93,10 +96,24 @@ void initLogger(const spdlog::level::level_enum& LoggingLevel,
     sinks.push_back(file_sink);
   }
 
-  auto combined_logger = std::make_shared<spdlog::logger>
-      ("nuclei_logger", begin(sinks), end(sinks));
+  std::shared_ptr<spdlog::logger> combined_logger;
+  if (async.enabled)
+  {
+    // a single worker keeps the messages in order
+    spdlog::init_thread_pool(std::max<size_t>(async.queue_size, 1), 1);
+    auto policy = (async.overflow == AsyncOptions::Overflow::Block)
+        ? spdlog::async_overflow_policy::block
+        : spdlog::async_overflow_policy::overrun_oldest;
+    combined_logger = std::make_shared<spdlog::async_logger>
+        ("nuclei_logger", begin(sinks), end(sinks), spdlog::thread_pool(), policy);
+  }
+  else
+    combined_logger = std::make_shared<spdlog::logger>
+        ("nuclei_logger", begin(sinks), end(sinks));
+
   combined_logger->set_level(LoggingLevel);
-  combined_logger->flush_on(LoggingLevel);
+  // errors are flushed right away, everything else periodically
+  combined_logger->flush_on(spdlog::level::err);
   spdlog::flush_every(std::chrono::seconds(1));
   spdlog::set_default_logger(combined_logger);
 }
@@ -104,8 +121,20 @@ void initLogger(const spdlog::level::level_enum& LoggingLevel,
 void closeLogger()
 {
   // Release all spdlog resources, and drop all loggers in the registry.
-  // This is optional (only mandatory if using windows + async log).
+  // Joins the async worker after it has written the queued messages.
+  if (auto pool = spdlog::thread_pool())
+    if (auto dropped = pool->overrun_counter())
+      WARN("<CustomLogger> Dropped {} messages on a full log queue", dropped);
+  auto level = spdlog::default_logger() ? spdlog::default_logger()->level()
+                                        : spdlog::level::info;
   spdlog::shutdown();
+
+  // destructors and teardown code may still log, without a default
+  // logger they would dereference null
+  auto fallback = std::make_shared<spdlog::logger>(
+        "nuclei_logger", std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+  fallback->set_level(level);
+  spdlog::set_default_logger(fallback);
 }
 
 }
\ No newline at end of file
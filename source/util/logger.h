@@ -14,21 +14,49 @@
 namespace CustomLogger
 {
 
+// Messages are queued and written by a background thread, so logging
+// costs the caller a queue push. When the bounded queue is full, callers
+// wait for room by default, or may choose to overwrite the oldest queued
+// message, errors included.
+struct AsyncOptions
+{
+  enum class Overflow { Block, DropOldest };
+
+  bool enabled {true};
+  size_t queue_size {8192};
+  Overflow overflow {Overflow::Block};
+};
+
 void initLogger(const spdlog::level::level_enum& LoggingLevel,
                 const std::string& log_file_name,
-                std::ostream* gui_stream = nullptr);
+                std::ostream* gui_stream = nullptr,
+                const AsyncOptions& async = AsyncOptions());
+// writes out what is queued; later messages go straight to stderr
 void closeLogger();
 
 }
 
-#define LOG(Severity, Format, ...) spdlog::log(Severity, Format, ##__VA_ARGS__)
+// Arguments are only evaluated if the message is going to be written
+#define LOG_ENABLED(Severity) spdlog::should_log(Severity)
+#define LOG_IF(Enabled, Severity, Format, ...) \
+  do { if (Enabled) spdlog::log(Severity, Format, ##__VA_ARGS__); } while (0)
+#define LOG(Severity, Format, ...) LOG_IF(LOG_ENABLED(Severity), Severity, Format, ##__VA_ARGS__)
+
+// NUCLEI_STRIP_DEBUG_LOGS compiles debug and trace messages out entirely
+#ifdef NUCLEI_STRIP_DEBUG_LOGS
+#define DBG_ENABLED false
+#define TRC_ENABLED false
+#else
+#define DBG_ENABLED LOG_ENABLED(spdlog::level::debug)
+#define TRC_ENABLED LOG_ENABLED(spdlog::level::trace)
+#endif
 
 #define CRIT(Format, ...) LOG(spdlog::level::critical, Format, ##__VA_ARGS__)
 #define ERR(Format, ...) LOG(spdlog::level::err, Format, ##__VA_ARGS__)
 #define WARN(Format, ...) LOG(spdlog::level::warn, Format, ##__VA_ARGS__)
 #define INFO(Format, ...) LOG(spdlog::level::info, Format, ##__VA_ARGS__)
-#define DBG(Format, ...) LOG(spdlog::level::debug, Format, ##__VA_ARGS__)
-#define TRC(Format, ...) LOG(spdlog::level::trace, Format, ##__VA_ARGS__)
+#define DBG(Format, ...) LOG_IF(DBG_ENABLED, spdlog::level::debug, Format, ##__VA_ARGS__)
+#define TRC(Format, ...) LOG_IF(TRC_ENABLED, spdlog::level::trace, Format, ##__VA_ARGS__)
 
 //#define LOGL(Severity, Format, ...) Log::Msg(Severity, fmt::format(Format, ##__VA_ARGS__), {{"file", std::string(__FILE__)}, {"line", std::int64_t(__LINE__)}})
 //
@@ -0,0 +1,205 @@
+#include <util/trace.h>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace
+{
+
+namespace
+{
+
+// bounds memory if tracing is left on, about 24 MB per thread
+constexpr size_t max_events_per_thread = 1 << 20;
+
+struct Event
+{
+  const char* name;
+  int64_t begin_ns;
+  int64_t end_ns;
+};
+
+struct ThreadLog
+{
+  uint32_t tid {0};
+  std::string name;
+  std::mutex mutex;
+  std::vector<Event> events;
+  size_t dropped {0};
+};
+
+// thread logs outlive their threads, so spans of finished workers are kept
+struct Registry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadLog>> logs;
+};
+
+Registry& registry()
+{
+  static Registry r;
+  return r;
+}
+
+ThreadLog& local_log()
+{
+  thread_local std::shared_ptr<ThreadLog> log = []()
+  {
+    auto l = std::make_shared<ThreadLog>();
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    l->tid = uint32_t(r.logs.size() + 1);
+    r.logs.push_back(l);
+    return l;
+  }();
+  return *log;
+}
+
+const auto epoch = std::chrono::steady_clock::now();
+
+std::string escape_json(const std::string& s)
+{
+  std::string ret;
+  ret.reserve(s.size());
+  for (char c : s)
+    if ((c == '"') || (c == '\\'))
+      (ret += '\\') += c;
+    else if (uint8_t(c) >= 0x20)
+      ret += c;
+  return ret;
+}
+
+}
+
+namespace detail
+{
+
+std::atomic<bool> enabled {false};
+
+int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+void record(const char* name, int64_t begin_ns, int64_t end_ns)
+{
+  auto& log = local_log();
+  std::lock_guard<std::mutex> lock(log.mutex);
+  if (log.events.size() < max_events_per_thread)
+    log.events.push_back({name, begin_ns, end_ns});
+  else
+    log.dropped++;
+}
+
+}
+
+void start()
+{
+  detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+  detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+void clear()
+{
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& log : r.logs)
+  {
+    std::lock_guard<std::mutex> l(log->mutex);
+    log->events.clear();
+    log->dropped = 0;
+  }
+}
+
+void set_thread_name(const std::string& name)
+{
+  auto& log = local_log();
+  std::lock_guard<std::mutex> lock(log.mutex);
+  log.name = name;
+}
+
+size_t event_count()
+{
+  size_t ret {0};
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& log : r.logs)
+  {
+    std::lock_guard<std::mutex> l(log->mutex);
+    ret += log->events.size();
+  }
+  return ret;
+}
+
+bool write(const std::string& file_name)
+{
+  std::ofstream file(file_name, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+    return false;
+
+  fmt::memory_buffer out;
+  fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  bool first {true};
+  auto separator = [&]()
+  {
+    if (!first)
+      out.push_back(',');
+    out.push_back('\n');
+    first = false;
+  };
+
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& log : r.logs)
+  {
+    std::lock_guard<std::mutex> l(log->mutex);
+    if (log->events.empty())
+      continue;
+
+    separator();
+    fmt::format_to(std::back_inserter(out),
+                   "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                   "\"args\":{{\"name\":\"{}\"}}}}",
+                   log->tid, log->name.empty()
+                   ? fmt::format("thread {}", log->tid)
+                   : escape_json(log->name));
+
+    // complete events, timestamps in microseconds
+    for (const auto& e : log->events)
+    {
+      separator();
+      fmt::format_to(std::back_inserter(out),
+                     "{{\"name\":\"{}\",\"cat\":\"nuclei\",\"ph\":\"X\",\"pid\":1,"
+                     "\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                     escape_json(e.name), log->tid,
+                     1e-3 * double(e.begin_ns),
+                     1e-3 * double(e.end_ns - e.begin_ns));
+    }
+
+    if (log->dropped)
+    {
+      separator();
+      fmt::format_to(std::back_inserter(out),
+                     "{{\"name\":\"{} events dropped\",\"ph\":\"i\",\"s\":\"t\","
+                     "\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+                     log->dropped, log->tid,
+                     1e-3 * double(log->events.back().end_ns));
+    }
+  }
+  fmt::format_to(std::back_inserter(out), "\n]}}\n");
+
+  file.write(out.data(), std::streamsize(out.size()));
+  return bool(file);
+}
+
+}
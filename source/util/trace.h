@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped spans written out as Chrome trace events, readable by
+// chrome://tracing and ui.perfetto.dev.
+//
+// Tracing is off until start(); a disabled span costs one relaxed atomic
+// load. Each thread records into its own buffer, so spans on different
+// threads never contend. Span names must outlive the trace, in practice
+// string literals.
+namespace Trace
+{
+
+namespace detail
+{
+extern std::atomic<bool> enabled;
+int64_t now_ns();
+void record(const char* name, int64_t begin_ns, int64_t end_ns);
+}
+
+inline bool enabled()
+{
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void start();
+void stop();
+void clear();
+
+// shown in the trace viewer instead of the thread number
+void set_thread_name(const std::string& name);
+
+size_t event_count();
+bool write(const std::string& file_name);
+
+class Span
+{
+public:
+  explicit Span(const char* name)
+    : name_(enabled() ? name : nullptr)
+    , begin_(name_ ? detail::now_ns() : 0)
+  {}
+
+  ~Span()
+  {
+    if (name_)
+      detail::record(name_, begin_, detail::now_ns());
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+private:
+  const char* name_;
+  int64_t begin_;
+};
+
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)